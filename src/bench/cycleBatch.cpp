@@ -0,0 +1,87 @@
+/* {{{ LICENSE
+ * cycleBatch.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * Compares dea::CycleBatch against stepping every dea::StaticCycle
+ * on its own.
+ */
+
+// {{{ Includes
+#include "cycleBatch.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+// }}} Includes
+
+namespace
+{
+
+typedef dea::StaticCycle<int,0,999,7,dea::StaticCountStdOverload> Phase;
+
+const std::size_t Count  = 1 << 16;
+const int         Rounds = 2000;
+
+template <typename F>
+double NsPerElement(F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < Rounds; ++r)
+        f();
+    const std::chrono::duration<double,std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (double(Rounds) * Count);
+}
+
+} // namespace
+
+int main()
+{
+    auto counter = std::make_shared<long int>(0);
+    std::vector<Phase> cycles;
+    cycles.reserve(Count);
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        cycles.emplace_back(static_cast<int>(i % 1000));
+        cycles.back().setCounter(counter);
+    }
+
+    std::vector<int> values(Count);
+    for (std::size_t i = 0; i < Count; ++i)
+        values[i] = static_cast<int>(i % 1000);
+    long int wraps = 0;
+
+    const double scalarAdd = NsPerElement([&]
+        { for (auto& c : cycles) c += 37; });
+    const double batchAdd = NsPerElement([&]
+        { wraps += dea::CycleBatch<Phase>::Add(values.data(),Count,37); });
+    const double scalarStep = NsPerElement([&]
+        { for (auto& c : cycles) ++c; });
+    const double batchStep = NsPerElement([&]
+        { wraps += dea::CycleBatch<Phase>::Advance(values.data(),Count); });
+
+    std::printf("StaticCycle::operator+= %8.3f ns/element\n",scalarAdd);
+    std::printf("CycleBatch::Add         %8.3f ns/element\n",batchAdd);
+    std::printf("StaticCycle::operator++ %8.3f ns/element\n",scalarStep);
+    std::printf("CycleBatch::Advance     %8.3f ns/element\n",batchStep);
+    std::printf("wraps: %ld (scalar) %ld (batch)\n",*counter,wraps);
+
+    return *counter == wraps ? 0 : 1;
+}
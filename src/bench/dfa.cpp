@@ -0,0 +1,216 @@
+/* {{{ LICENSE
+ * dfa.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * Compares the throughput of dea::Dfa with hand-written switch machines
+ * for the same languages: counting "ERROR" in log lines, where the
+ * start state is accelerated, and validating lines of comma separated
+ * integers, where every byte goes through the table.
+ */
+
+// {{{ Includes
+#include "dfa.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+// }}} Includes
+
+namespace
+{
+
+const std::size_t Size   = 1 << 25;
+const int         Rounds = 8;
+
+template <typename F>
+double GBytesPerSecond(F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < Rounds; ++r)
+        f();
+    const std::chrono::duration<double,std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return double(Rounds) * Size / elapsed.count();
+}
+
+// {{{ "ERROR" in log lines
+struct Idle; struct E; struct ER; struct ERR; struct ERRO; struct Error;
+typedef dea::DfaChars<'E'> CharE;
+
+typedef dea::Dfa<
+    dea::TL::MakeTypelist<Idle,E,ER,ERR,ERRO,Error>::Result,
+    dea::TL::MakeTypelist<Error>::Result,
+    dea::TL::MakeTypelist<
+        dea::DfaEdge<Idle,CharE,E>,
+        dea::DfaEdge<Idle,dea::DfaAny,Idle>,
+        dea::DfaEdge<E,dea::DfaChars<'R'>,ER>,
+        dea::DfaEdge<E,CharE,E>,
+        dea::DfaEdge<E,dea::DfaAny,Idle>,
+        dea::DfaEdge<ER,dea::DfaChars<'R'>,ERR>,
+        dea::DfaEdge<ER,CharE,E>,
+        dea::DfaEdge<ER,dea::DfaAny,Idle>,
+        dea::DfaEdge<ERR,dea::DfaChars<'O'>,ERRO>,
+        dea::DfaEdge<ERR,CharE,E>,
+        dea::DfaEdge<ERR,dea::DfaAny,Idle>,
+        dea::DfaEdge<ERRO,dea::DfaChars<'R'>,Error>,
+        dea::DfaEdge<ERRO,CharE,E>,
+        dea::DfaEdge<ERRO,dea::DfaAny,Idle>,
+        dea::DfaEdge<Error,CharE,E>,
+        dea::DfaEdge<Error,dea::DfaAny,Idle>>::Result> ErrorDfa;
+
+std::size_t CountSwitch(const char* p, const char* end)
+{
+    std::size_t count = 0;
+    int state = 0;
+    for (; p != end; ++p)
+    {
+        const char c = *p;
+        switch (state)
+        {
+            case 0: case 5:
+                state = c == 'E';
+                break;
+            case 1:
+                state = c == 'R' ? 2 : c == 'E';
+                break;
+            case 2:
+                state = c == 'R' ? 3 : c == 'E';
+                break;
+            case 3:
+                state = c == 'O' ? 4 : c == 'E';
+                break;
+            case 4:
+                if (c == 'R')
+                {
+                    state = 5;
+                    ++count;
+                }
+                else
+                    state = c == 'E';
+                break;
+        }
+    }
+    return count;
+}
+
+std::size_t CountDfa(const char* p, const char* end)
+{
+    std::size_t count = 0;
+    ErrorDfa::Scan(ErrorDfa::Start(),p,end,[&count](const char*)
+        { ++count; });
+    return count;
+}
+// }}} "ERROR" in log lines
+
+// {{{ Lines of integers
+struct LineStart; struct Number; struct Comma;
+typedef dea::DfaRange<'0','9'> Digit;
+
+typedef dea::Dfa<
+    dea::TL::MakeTypelist<LineStart,Number,Comma>::Result,
+    dea::TL::MakeTypelist<LineStart>::Result,
+    dea::TL::MakeTypelist<
+        dea::DfaEdge<LineStart,Digit,Number>,
+        dea::DfaEdge<Number,Digit,Number>,
+        dea::DfaEdge<Number,dea::DfaChars<','>,Comma>,
+        dea::DfaEdge<Number,dea::DfaChars<'\n'>,LineStart>,
+        dea::DfaEdge<Comma,Digit,Number>>::Result> CsvDfa;
+
+bool ValidSwitch(const char* p, const char* end)
+{
+    int state = 0;
+    for (; p != end; ++p)
+    {
+        const char c = *p;
+        const bool digit = c >= '0' && c <= '9';
+        switch (state)
+        {
+            case 0: case 2:
+                if (!digit)
+                    return false;
+                state = 1;
+                break;
+            case 1:
+                if (c == ',')
+                    state = 2;
+                else if (c == '\n')
+                    state = 0;
+                else if (!digit)
+                    return false;
+                break;
+        }
+    }
+    return state == 0;
+}
+
+bool ValidDfa(const char* p, const char* end)
+{ return CsvDfa::Match(p,end - p); }
+// }}} Lines of integers
+
+} // namespace
+
+int main()
+{
+    std::string log;
+    log.reserve(Size + 128);
+    for (std::size_t line = 0; log.size() < Size; ++line)
+        log += line % 97 == 0
+            ? "2013-04-01 12:00:00 ERROR disk quota exceeded on /var\n"
+            : "2013-04-01 12:00:00 INFO request served in 12 ms, EOK\n";
+    log.resize(Size);
+
+    std::string csv;
+    csv.reserve(Size + 128);
+    for (std::size_t line = 0; csv.size() < Size; ++line)
+        csv += std::to_string(line * 7919 % 100000) + ",42," +
+            std::to_string(line) + "\n";
+    csv.resize(Size);
+    csv[Size - 1] = '\n';
+
+    const char* logBegin = log.data();
+    const char* logEnd = logBegin + log.size();
+    const char* csvBegin = csv.data();
+    const char* csvEnd = csvBegin + csv.size();
+
+    std::size_t countSwitch = 0, countDfa = 0;
+    bool validSwitch = false, validDfa = false;
+    const double scanSwitch = GBytesPerSecond([&]
+        { countSwitch = CountSwitch(logBegin,logEnd); });
+    const double scanDfa = GBytesPerSecond([&]
+        { countDfa = CountDfa(logBegin,logEnd); });
+    const double matchSwitch = GBytesPerSecond([&]
+        { validSwitch = ValidSwitch(csvBegin,csvEnd); });
+    const double matchDfa = GBytesPerSecond([&]
+        { validDfa = ValidDfa(csvBegin,csvEnd); });
+
+    const bool same = countSwitch == countDfa && validSwitch == validDfa;
+
+    std::printf("ERROR count, switch  %8.3f GB/s\n",scanSwitch);
+    std::printf("ERROR count, Dfa     %8.3f GB/s (%d classes)\n",scanDfa,
+        int(ErrorDfa::classes));
+    std::printf("csv lines, switch    %8.3f GB/s\n",matchSwitch);
+    std::printf("csv lines, Dfa       %8.3f GB/s (%d classes)\n",matchDfa,
+        int(CsvDfa::classes));
+    std::printf("results %s (%zu matches, %s)\n",same ? "match" : "DIFFER",
+        countDfa,validDfa ? "valid" : "invalid");
+
+    return same ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+/* {{{ LICENSE
+ * dynamicCycle.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * Compares dea::DynamicCycle against plain modulo with a runtime ring
+ * size.
+ */
+
+// {{{ Includes
+#include "dynamicCycle.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+// }}} Includes
+
+namespace
+{
+
+const int Iterations = 1 << 26;
+
+template <typename F>
+double NsPerOp(F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const std::chrono::duration<double,std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / Iterations;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    // read the ring size at runtime so the compiler can't fold the modulo
+    const unsigned int size = argc > 1 ? std::atoi(argv[1]) : 1000;
+
+    std::vector<unsigned int> offsets(1024);
+    for (std::size_t i = 0; i < offsets.size(); ++i)
+        offsets[i] = static_cast<unsigned int>(i * 7919u + 12345u);
+
+    unsigned int modValue = 0;
+    dea::DynamicCycle<unsigned int> cycle{0,size-1};
+
+    const double modAdd = NsPerOp([&]
+    {
+        for (int i = 0; i < Iterations; ++i)
+            modValue = (modValue + offsets[i & 1023]) % size;
+    });
+    const double cycleAdd = NsPerOp([&]
+    {
+        for (int i = 0; i < Iterations; ++i)
+            cycle += offsets[i & 1023];
+    });
+    const double modStep = NsPerOp([&]
+    {
+        for (int i = 0; i < Iterations; ++i)
+            modValue = (modValue + 1) % size;
+    });
+    const double cycleStep = NsPerOp([&]
+    {
+        for (int i = 0; i < Iterations; ++i)
+            ++cycle;
+    });
+
+    std::printf("ring size %u\n",size);
+    std::printf("(v + offset) %% size      %8.3f ns/op\n",modAdd);
+    std::printf("DynamicCycle::operator+= %8.3f ns/op\n",cycleAdd);
+    std::printf("(v + 1) %% size           %8.3f ns/op\n",modStep);
+    std::printf("DynamicCycle::operator++ %8.3f ns/op\n",cycleStep);
+
+    return modValue == cycle() ? 0 : 1;
+}
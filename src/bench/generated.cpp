@@ -0,0 +1,336 @@
+/* {{{ LICENSE
+ * generated.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * Times the code dea generates against what one would write by hand:
+ *  - Field access on dea::Tuple against std::get on std::tuple
+ *  - dea::StaticCycle increment and += under every overload policy
+ *    against hand-written modulo
+ *  - calls into dea::GenScatterHierarchy and dea::GenLinearHiearchy
+ *    units against virtual calls
+ *
+ * Results go to stdout as CSV (benchmark,variant,ns_per_op), so runs can
+ * be diffed or fed to a script; the check whether every variant computed
+ * the same goes to stderr.
+ */
+
+// {{{ Includes
+#include "cycle.h"
+#include "hierarchy.h"
+#include "typelist.h"
+#include "typemap.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <tuple>
+#include <vector>
+// }}} Includes
+
+namespace
+{
+
+const std::size_t Count  = 1 << 16;
+const int         Rounds = 500;
+
+template <typename F>
+double NsPerOp(std::size_t ops, F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < Rounds; ++r)
+        f();
+    const std::chrono::duration<double,std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (double(Rounds) * ops);
+}
+
+void Report(const char* benchmark, const char* variant, double ns)
+{ std::printf("%s,%s,%.3f\n",benchmark,variant,ns); }
+
+// {{{ Tuple fields
+typedef dea::Tuple<dea::TL::MakeTypelist<int,double,long>::Result>
+    DeaRecord;
+typedef std::tuple<int,double,long> StdRecord;
+
+long SumByIndex(const std::vector<DeaRecord>& records)
+{
+    long sum = 0;
+    for (const DeaRecord& r : records)
+        sum += dea::Field<0>(r) + long(dea::Field<1>(r)) + dea::Field<2>(r);
+    return sum;
+}
+
+long SumByType(const std::vector<DeaRecord>& records)
+{
+    long sum = 0;
+    for (const DeaRecord& r : records)
+    {
+        const int& i = dea::Field<int>(r);
+        const double& d = dea::Field<double>(r);
+        const long& l = dea::Field<long>(r);
+        sum += i + long(d) + l;
+    }
+    return sum;
+}
+
+long SumStd(const std::vector<StdRecord>& records)
+{
+    long sum = 0;
+    for (const StdRecord& r : records)
+        sum += std::get<0>(r) + long(std::get<1>(r)) + std::get<2>(r);
+    return sum;
+}
+// }}} Tuple fields
+
+// {{{ StaticCycle
+const int Min = 0, Max = 999, Step = 7;
+
+template <template <typename,int,int> class OnOverload>
+struct Policy;
+template <>
+struct Policy<dea::StaticStdOverload>
+{
+    static const char* Name() { return "StaticStdOverload"; }
+    template <typename C>
+    static void Attach(C&) {}
+};
+template <>
+struct Policy<dea::StaticCountStdOverload>
+{
+    static const char* Name() { return "StaticCountStdOverload"; }
+    template <typename C>
+    static void Attach(C& c)
+    { c.setCounter(std::make_shared<long int>(0)); }
+};
+template <>
+struct Policy<dea::StaticCountMaxOverload>
+{
+    static const char* Name() { return "StaticCountMaxOverload"; }
+    template <typename C>
+    static void Attach(C& c)
+    { c.setCounter(std::make_shared<std::size_t>(0)); }
+};
+
+template <template <typename,int,int> class OnOverload>
+long IncrementCycle(std::size_t n)
+{
+    dea::StaticCycle<int,Min,Max,Step,OnOverload> cycle(0);
+    Policy<OnOverload>::Attach(cycle);
+    long sum = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        sum += (++cycle)();
+    return sum;
+}
+
+long IncrementModulo(std::size_t n)
+{
+    int value = 0;
+    long sum = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        value = (value - Min + Step) % (Max - Min + 1) + Min;
+        sum += value;
+    }
+    return sum;
+}
+
+template <template <typename,int,int> class OnOverload>
+long AddCycle(const std::vector<int>& amounts)
+{
+    dea::StaticCycle<int,Min,Max,Step,OnOverload> cycle(0);
+    Policy<OnOverload>::Attach(cycle);
+    long sum = 0;
+    for (int amount : amounts)
+        sum += (cycle += amount)();
+    return sum;
+}
+
+long AddModulo(const std::vector<int>& amounts)
+{
+    int value = 0;
+    long sum = 0;
+    for (int amount : amounts)
+    {
+        value = (value - Min + amount) % (Max - Min + 1) + Min;
+        sum += value;
+    }
+    return sum;
+}
+// }}} StaticCycle
+
+// {{{ Hierarchy units
+struct Small  { enum { weight = 3 }; };
+struct Medium { enum { weight = 5 }; };
+struct Large  { enum { weight = 7 }; };
+typedef dea::TL::MakeTypelist<Small,Medium,Large>::Result Sizes;
+
+template <typename T>
+struct ScatterHandler
+{
+    long total = 0;
+    void On(int x) { total += T::weight * x; }
+};
+typedef dea::GenScatterHierarchy<Sizes,ScatterHandler> ScatterHandlers;
+
+struct LinearRoot
+{
+    void On();
+    void Total();
+};
+template <typename T, typename Base>
+struct LinearHandler : public Base
+{
+    long total = 0;
+    using Base::On;
+    using Base::Total;
+    void On(dea::Type2Type<T>, int x) { total += T::weight * x; }
+    long Total(dea::Type2Type<T>) const { return total; }
+};
+typedef dea::GenLinearHiearchy<Sizes,LinearHandler,LinearRoot>
+    LinearHandlers;
+
+struct VirtualHandler
+{
+    long total = 0;
+    virtual ~VirtualHandler() = default;
+    virtual void On(int x) = 0;
+};
+template <typename T>
+struct VirtualUnit : public VirtualHandler
+{
+    void On(int x) override { total += T::weight * x; }
+};
+
+long CallScatter(const std::vector<int>& input)
+{
+    ScatterHandlers handlers;
+    for (int x : input)
+    {
+        dea::Field<Small>(handlers).On(x);
+        dea::Field<Medium>(handlers).On(x);
+        dea::Field<Large>(handlers).On(x);
+    }
+    return dea::Field<Small>(handlers).total +
+        dea::Field<Medium>(handlers).total +
+        dea::Field<Large>(handlers).total;
+}
+
+long CallLinear(const std::vector<int>& input)
+{
+    LinearHandlers handlers;
+    for (int x : input)
+    {
+        handlers.On(dea::Type2Type<Small>(),x);
+        handlers.On(dea::Type2Type<Medium>(),x);
+        handlers.On(dea::Type2Type<Large>(),x);
+    }
+    return handlers.Total(dea::Type2Type<Small>()) +
+        handlers.Total(dea::Type2Type<Medium>()) +
+        handlers.Total(dea::Type2Type<Large>());
+}
+
+long CallVirtual(const std::vector<std::unique_ptr<VirtualHandler>>& handlers,
+    const std::vector<int>& input)
+{
+    for (const auto& handler : handlers)
+        handler->total = 0;
+    for (int x : input)
+        for (const auto& handler : handlers)
+            handler->On(x);
+    long total = 0;
+    for (const auto& handler : handlers)
+        total += handler->total;
+    return total;
+}
+// }}} Hierarchy units
+
+} // namespace
+
+int main()
+{
+    std::vector<DeaRecord> deaRecords(Count);
+    std::vector<StdRecord> stdRecords(Count);
+    std::vector<int> input(Count);
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        const int x = static_cast<int>(i * 7919 % 1000);
+        dea::Field<0>(deaRecords[i]) = x;
+        dea::Field<1>(deaRecords[i]) = x * 0.5;
+        dea::Field<2>(deaRecords[i]) = long(i);
+        stdRecords[i] = StdRecord(x,x * 0.5,long(i));
+        input[i] = x;
+    }
+
+    std::vector<std::unique_ptr<VirtualHandler>> virtuals;
+    virtuals.emplace_back(new VirtualUnit<Small>);
+    virtuals.emplace_back(new VirtualUnit<Medium>);
+    virtuals.emplace_back(new VirtualUnit<Large>);
+
+    long r[14] = {};
+    bool same = true;
+
+    std::printf("benchmark,variant,ns_per_op\n");
+
+    Report("tuple_field","dea::Field<i>",NsPerOp(Count,[&]
+        { r[0] = SumByIndex(deaRecords); }));
+    Report("tuple_field","dea::Field<T>",NsPerOp(Count,[&]
+        { r[1] = SumByType(deaRecords); }));
+    Report("tuple_field","std::get<i>",NsPerOp(Count,[&]
+        { r[2] = SumStd(stdRecords); }));
+    same = same && r[0] == r[2] && r[1] == r[2];
+
+    Report("cycle_increment",Policy<dea::StaticStdOverload>::Name(),
+        NsPerOp(Count,[&]
+        { r[3] = IncrementCycle<dea::StaticStdOverload>(Count); }));
+    Report("cycle_increment",Policy<dea::StaticCountStdOverload>::Name(),
+        NsPerOp(Count,[&]
+        { r[4] = IncrementCycle<dea::StaticCountStdOverload>(Count); }));
+    Report("cycle_increment",Policy<dea::StaticCountMaxOverload>::Name(),
+        NsPerOp(Count,[&]
+        { r[5] = IncrementCycle<dea::StaticCountMaxOverload>(Count); }));
+    Report("cycle_increment","modulo",NsPerOp(Count,[&]
+        { r[6] = IncrementModulo(Count); }));
+    same = same && r[3] == r[6] && r[4] == r[6] && r[5] == r[6];
+
+    Report("cycle_add",Policy<dea::StaticStdOverload>::Name(),
+        NsPerOp(Count,[&]
+        { r[7] = AddCycle<dea::StaticStdOverload>(input); }));
+    Report("cycle_add",Policy<dea::StaticCountStdOverload>::Name(),
+        NsPerOp(Count,[&]
+        { r[8] = AddCycle<dea::StaticCountStdOverload>(input); }));
+    Report("cycle_add",Policy<dea::StaticCountMaxOverload>::Name(),
+        NsPerOp(Count,[&]
+        { r[9] = AddCycle<dea::StaticCountMaxOverload>(input); }));
+    Report("cycle_add","modulo",NsPerOp(Count,[&]
+        { r[10] = AddModulo(input); }));
+    same = same && r[7] == r[10] && r[8] == r[10] && r[9] == r[10];
+
+    Report("unit_call","GenScatterHierarchy",NsPerOp(3 * Count,[&]
+        { r[11] = CallScatter(input); }));
+    Report("unit_call","GenLinearHiearchy",NsPerOp(3 * Count,[&]
+        { r[12] = CallLinear(input); }));
+    Report("unit_call","virtual",NsPerOp(3 * Count,[&]
+        { r[13] = CallVirtual(virtuals,input); }));
+    same = same && r[11] == r[13] && r[12] == r[13];
+
+    std::fprintf(stderr,"results %s\n",same ? "match" : "DIFFER");
+
+    return same ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+/* {{{ LICENSE
+ * parallelScan.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * Writes a log file to /tmp, maps it and counts "ERROR" in it with a
+ * dea::Dfa, once sequentially and once with a dea::ParallelScanner on
+ * every hardware thread.
+ */
+
+// {{{ Includes
+#include "dfa.h"
+#include "mappedFile.h"
+#include "parallelScanner.h"
+#include "threadPool.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#include <stdlib.h>
+#include <unistd.h>
+// }}} Includes
+
+namespace
+{
+
+const std::size_t Size   = std::size_t(1) << 28;
+const int         Rounds = 4;
+
+template <typename F>
+double GBytesPerSecond(std::size_t size, F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < Rounds; ++r)
+        f();
+    const std::chrono::duration<double,std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return double(Rounds) * size / elapsed.count();
+}
+
+struct Idle; struct E; struct ER; struct ERR; struct ERRO; struct Error;
+typedef dea::DfaChars<'E'> CharE;
+
+typedef dea::Dfa<
+    dea::TL::MakeTypelist<Idle,E,ER,ERR,ERRO,Error>::Result,
+    dea::TL::MakeTypelist<Error>::Result,
+    dea::TL::MakeTypelist<
+        dea::DfaEdge<Idle,CharE,E>,
+        dea::DfaEdge<Idle,dea::DfaAny,Idle>,
+        dea::DfaEdge<E,dea::DfaChars<'R'>,ER>,
+        dea::DfaEdge<E,CharE,E>,
+        dea::DfaEdge<E,dea::DfaAny,Idle>,
+        dea::DfaEdge<ER,dea::DfaChars<'R'>,ERR>,
+        dea::DfaEdge<ER,CharE,E>,
+        dea::DfaEdge<ER,dea::DfaAny,Idle>,
+        dea::DfaEdge<ERR,dea::DfaChars<'O'>,ERRO>,
+        dea::DfaEdge<ERR,CharE,E>,
+        dea::DfaEdge<ERR,dea::DfaAny,Idle>,
+        dea::DfaEdge<ERRO,dea::DfaChars<'R'>,Error>,
+        dea::DfaEdge<ERRO,CharE,E>,
+        dea::DfaEdge<ERRO,dea::DfaAny,Idle>,
+        dea::DfaEdge<Error,CharE,E>,
+        dea::DfaEdge<Error,dea::DfaAny,Idle>>::Result> ErrorDfa;
+
+} // namespace
+
+int main()
+{
+    char path[] = "/tmp/dea-parallelScan-XXXXXX";
+    const int fd = ::mkstemp(path);
+    if (fd < 0)
+    {
+        std::perror("mkstemp");
+        return 1;
+    }
+    {
+        std::string chunk;
+        for (std::size_t line = 0; chunk.size() < (1 << 20); ++line)
+            chunk += line % 97 == 0
+                ? "2013-04-01 12:00:00 ERROR disk quota exceeded on /var\n"
+                : "2013-04-01 12:00:00 INFO request served in 12 ms, EOK\n";
+        for (std::size_t written = 0; written < Size; written += chunk.size())
+            if (::write(fd,chunk.data(),chunk.size()) < 0)
+            {
+                std::perror("write");
+                ::close(fd);
+                ::unlink(path);
+                return 1;
+            }
+        ::close(fd);
+    }
+
+    bool same = false;
+    {
+        dea::MappedFile log(path);
+        dea::ThreadPool pool;
+
+        std::size_t sequential = 0, parallel = 0;
+        const double sequentialRate = GBytesPerSecond(log.Size(),[&]
+        {
+            sequential = 0;
+            ErrorDfa::Scan(ErrorDfa::Start(),log.begin(),log.end(),
+                [&sequential](const char*) { ++sequential; });
+        });
+        dea::ParallelScanner<ErrorDfa> scanner(pool);
+        const double parallelRate = GBytesPerSecond(log.Size(),[&]
+        {
+            parallel = scanner.Count(ErrorDfa::Start(),log.begin(),
+                log.end());
+        });
+        same = sequential == parallel;
+
+        std::printf("ERROR count, sequential   %8.3f GB/s\n",sequentialRate);
+        std::printf("ERROR count, %2u threads   %8.3f GB/s\n",
+            static_cast<unsigned int>(pool.Size()),parallelRate);
+        std::printf("results %s (%zu matches)\n",same ? "match" : "DIFFER",
+            parallel);
+    }
+    ::unlink(path);
+
+    return same ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+/* {{{ LICENSE
+ * ring.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * Compares throughput and round-trip latency of dea::SpscRing and
+ * dea::MpmcRing against a mutex-protected std::deque.
+ */
+
+// {{{ Includes
+#include "ring.h"
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+// }}} Includes
+
+namespace
+{
+
+const long int   Items     = 1 << 21;
+const long int   RoundTrips = 1 << 15;
+const std::size_t Capacity = 1024;
+const std::size_t Batch    = 32;
+
+// {{{ class LockedDeque
+class LockedDeque
+{
+    std::mutex mutex_;
+    std::deque<long int> items_;
+
+    public:
+        bool Push(long int item)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (items_.size() == Capacity)
+                return false;
+            items_.push_back(item);
+            return true;
+        }
+        bool Pop(long int& item)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (items_.empty())
+                return false;
+            item = items_.front();
+            items_.pop_front();
+            return true;
+        }
+        std::size_t PushN(const long int* items, std::size_t n)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::size_t count = 0;
+            for (; count < n && items_.size() < Capacity; ++count)
+                items_.push_back(items[count]);
+            return count;
+        }
+        std::size_t PopN(long int* items, std::size_t n)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::size_t count = 0;
+            for (; count < n && !items_.empty(); ++count)
+            {
+                items[count] = items_.front();
+                items_.pop_front();
+            }
+            return count;
+        }
+};
+// }}} class LockedDeque
+
+double Seconds(std::chrono::steady_clock::time_point start)
+{
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// one producer, one consumer, one element per call
+template <typename Queue>
+double Single()
+{
+    Queue queue;
+    const auto start = std::chrono::steady_clock::now();
+    std::thread producer([&]
+    {
+        for (long int i = 0; i < Items; )
+            if (queue.Push(i)) ++i; else std::this_thread::yield();
+    });
+    long int item, sum = 0;
+    for (long int i = 0; i < Items; )
+        if (queue.Pop(item)) { sum += item; ++i; }
+        else std::this_thread::yield();
+    producer.join();
+    return Items / Seconds(start) / 1e6;
+}
+
+// one producer, one consumer, Batch elements per call
+template <typename Queue>
+double Batched()
+{
+    Queue queue;
+    const auto start = std::chrono::steady_clock::now();
+    std::thread producer([&]
+    {
+        long int items[Batch];
+        for (long int i = 0; i < Items; )
+        {
+            for (std::size_t k = 0; k < Batch; ++k) items[k] = i + k;
+            const std::size_t n = queue.PushN(items,Batch);
+            if (!n) std::this_thread::yield();
+            i += n;
+        }
+    });
+    long int items[Batch], sum = 0;
+    for (long int i = 0; i < Items; )
+    {
+        const std::size_t n = queue.PopN(items,Batch);
+        if (!n) std::this_thread::yield();
+        for (std::size_t k = 0; k < n; ++k) sum += items[k];
+        i += n;
+    }
+    producer.join();
+    return Items / Seconds(start) / 1e6;
+}
+
+// ping-pong through two queues, returns microseconds per round trip
+template <typename Queue>
+double RoundTrip()
+{
+    Queue ping, pong;
+    std::thread echo([&]
+    {
+        long int item;
+        for (long int i = 0; i < RoundTrips; )
+            if (ping.Pop(item)) { while (!pong.Push(item)) {} ++i; }
+            else std::this_thread::yield();
+    });
+    const auto start = std::chrono::steady_clock::now();
+    long int item;
+    for (long int i = 0; i < RoundTrips; ++i)
+    {
+        while (!ping.Push(i)) {}
+        while (!pong.Pop(item)) std::this_thread::yield();
+    }
+    const double us = Seconds(start) * 1e6 / RoundTrips;
+    echo.join();
+    return us;
+}
+
+template <typename Queue>
+void Report(const char* name)
+{
+    const double single = Single<Queue>();
+    const double batched = Batched<Queue>();
+    const double latency = RoundTrip<Queue>();
+    std::printf("%-22s %10.2f %14.2f %14.3f\n",name,single,batched,latency);
+}
+
+} // namespace
+
+int main()
+{
+    std::printf("%-22s %10s %14s %14s\n","queue","Mitems/s",
+        "Mitems/s (x32)","us/round trip");
+    Report<dea::SpscRing<long int,Capacity>>("dea::SpscRing");
+    Report<dea::MpmcRing<long int,Capacity>>("dea::MpmcRing");
+    Report<LockedDeque>("mutex + std::deque");
+    return 0;
+}
@@ -0,0 +1,164 @@
+/* {{{ LICENSE
+ * staticFor.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * Compares small fixed-size kernels written with dea::StaticFor and
+ * dea::Unroll against the same kernels as plain loops: a 4x4 transform
+ * of many vectors and a 16-lane checksum.
+ *
+ * Build with -fopt-info-vec (GCC) or -Rpass=loop-vectorize (Clang) to
+ * see which loops were vectorised.
+ */
+
+// {{{ Includes
+#include "typemap.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+// }}} Includes
+
+namespace
+{
+
+const std::size_t Count  = 1 << 16;
+const int         Rounds = 500;
+
+template <typename F>
+double NsPerElement(F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < Rounds; ++r)
+        f();
+    const std::chrono::duration<double,std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (double(Rounds) * Count);
+}
+
+// {{{ 4x4 transform
+struct Vec4 { float v[4]; };
+
+void TransformLoop(const float (&m)[4][4], const Vec4* in, Vec4* out,
+    std::size_t n)
+{
+    for (std::size_t k = 0; k < n; ++k)
+        for (int r = 0; r < 4; ++r)
+        {
+            float sum = 0.0f;
+            for (int c = 0; c < 4; ++c)
+                sum += m[r][c] * in[k].v[c];
+            out[k].v[r] = sum;
+        }
+}
+
+struct Row
+{
+    const float (&m)[4][4];
+    const Vec4& in;
+    Vec4& out;
+
+    template <int r>
+    void operator()(dea::Int2Type<r>) const
+    {
+        out.v[r] = m[r][0] * in.v[0] + m[r][1] * in.v[1] +
+                   m[r][2] * in.v[2] + m[r][3] * in.v[3];
+    }
+};
+
+void TransformStatic(const float (&m)[4][4], const Vec4* in, Vec4* out,
+    std::size_t n)
+{
+    for (std::size_t k = 0; k < n; ++k)
+        dea::StaticFor<0,4>::Do(Row{m,in[k],out[k]});
+}
+// }}} 4x4 transform
+
+// {{{ 16-lane checksum
+void ChecksumLoop(const std::uint8_t* data, std::size_t n,
+    std::uint32_t (&lanes)[16])
+{
+    for (std::size_t i = 0; i < n; ++i)
+        lanes[i % 16] += data[i];
+}
+
+struct Lane
+{
+    const std::uint8_t* data;
+    std::uint32_t (&lanes)[16];
+
+    template <int k>
+    void operator()(dea::Int2Type<k>) const { lanes[k] += data[k]; }
+};
+
+void ChecksumStatic(const std::uint8_t* data, std::size_t n,
+    std::uint32_t (&lanes)[16])
+{
+    std::size_t i = 0;
+    for (; n - i >= 16; i += 16)
+        dea::Unroll<16>::Do(Lane{data + i,lanes});
+    for (; i < n; ++i)
+        lanes[i % 16] += data[i];
+}
+// }}} 16-lane checksum
+
+} // namespace
+
+int main()
+{
+    float m[4][4];
+    for (int r = 0; r < 4; ++r)
+        for (int c = 0; c < 4; ++c)
+            m[r][c] = 0.25f * float(r + 1) - 0.125f * float(c);
+    std::vector<Vec4> in(Count), loopOut(Count), staticOut(Count);
+    for (std::size_t k = 0; k < Count; ++k)
+        for (int c = 0; c < 4; ++c)
+            in[k].v[c] = float((k * 7 + std::size_t(c)) % 101);
+
+    std::vector<std::uint8_t> bytes(Count * 16);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = static_cast<std::uint8_t>(i * 31 + (i >> 7));
+    std::uint32_t loopLanes[16] = {};
+    std::uint32_t staticLanes[16] = {};
+
+    const double transformLoop = NsPerElement([&]
+        { TransformLoop(m,in.data(),loopOut.data(),Count); });
+    const double transformStatic = NsPerElement([&]
+        { TransformStatic(m,in.data(),staticOut.data(),Count); });
+    const double checksumLoop = NsPerElement([&]
+        { ChecksumLoop(bytes.data(),bytes.size(),loopLanes); });
+    const double checksumStatic = NsPerElement([&]
+        { ChecksumStatic(bytes.data(),bytes.size(),staticLanes); });
+
+    bool same = true;
+    for (std::size_t k = 0; k < Count; ++k)
+        for (int c = 0; c < 4; ++c)
+            same = same && loopOut[k].v[c] == staticOut[k].v[c];
+    for (int k = 0; k < 16; ++k)
+        same = same && loopLanes[k] == staticLanes[k];
+
+    std::printf("4x4 transform, loops      %8.3f ns/vector\n",transformLoop);
+    std::printf("4x4 transform, StaticFor  %8.3f ns/vector\n",transformStatic);
+    std::printf("16-lane checksum, loop    %8.3f ns/16 bytes\n",checksumLoop);
+    std::printf("16-lane checksum, Unroll  %8.3f ns/16 bytes\n",checksumStatic);
+    std::printf("results %s\n",same ? "match" : "DIFFER");
+
+    return same ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+/* {{{ LICENSE
+ * staticHashTable.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * Compares a dea::StaticHashTable with a switch over the same sparse
+ * keys, looking up a stream of keys of which about one in four is not
+ * in the table.
+ */
+
+// {{{ Includes
+#include "staticHashTable.h"
+#include "typelist.h"
+#include "typemap.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+// }}} Includes
+
+namespace
+{
+
+const std::size_t Count  = 1 << 16;
+const int         Rounds = 500;
+
+template <typename F>
+double NsPerLookup(F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < Rounds; ++r)
+        f();
+    const std::chrono::duration<double,std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (double(Rounds) * Count);
+}
+
+const int Keys[] = {
+    0x01, 0x07, 0x10, 0x1b, 0x22, 0x2f, 0x3c, 0x41,
+    0x58, 0x63, 0x7f, 0x80, 0x9a, 0xa4, 0xbd, 0xc0,
+    0xd3, 0xe8, 0xff, 0x100, 0x1a0, 0x2bc, 0x3e8, 0x7d0 };
+
+#define DEA_BENCH_ENTRY(key) \
+    dea::StaticHashEntry<dea::Int2Type<key>,dea::Int2Type<(key) * 7 + 1>>
+
+typedef dea::StaticHashTable<dea::TL::MakeTypelist<
+    DEA_BENCH_ENTRY(0x01), DEA_BENCH_ENTRY(0x07), DEA_BENCH_ENTRY(0x10),
+    DEA_BENCH_ENTRY(0x1b), DEA_BENCH_ENTRY(0x22), DEA_BENCH_ENTRY(0x2f),
+    DEA_BENCH_ENTRY(0x3c), DEA_BENCH_ENTRY(0x41), DEA_BENCH_ENTRY(0x58),
+    DEA_BENCH_ENTRY(0x63), DEA_BENCH_ENTRY(0x7f), DEA_BENCH_ENTRY(0x80),
+    DEA_BENCH_ENTRY(0x9a), DEA_BENCH_ENTRY(0xa4), DEA_BENCH_ENTRY(0xbd),
+    DEA_BENCH_ENTRY(0xc0), DEA_BENCH_ENTRY(0xd3), DEA_BENCH_ENTRY(0xe8),
+    DEA_BENCH_ENTRY(0xff), DEA_BENCH_ENTRY(0x100), DEA_BENCH_ENTRY(0x1a0),
+    DEA_BENCH_ENTRY(0x2bc), DEA_BENCH_ENTRY(0x3e8), DEA_BENCH_ENTRY(0x7d0)
+    >::Result,int> Table;
+
+#undef DEA_BENCH_ENTRY
+
+int LookupSwitch(int key)
+{
+    switch (key)
+    {
+        case 0x01: case 0x07: case 0x10: case 0x1b: case 0x22: case 0x2f:
+        case 0x3c: case 0x41: case 0x58: case 0x63: case 0x7f: case 0x80:
+        case 0x9a: case 0xa4: case 0xbd: case 0xc0: case 0xd3: case 0xe8:
+        case 0xff: case 0x100: case 0x1a0: case 0x2bc: case 0x3e8:
+        case 0x7d0:
+            return key * 7 + 1;
+        default:
+            return 0;
+    }
+}
+
+long SumSwitch(const std::vector<int>& keys)
+{
+    long sum = 0;
+    for (int key : keys)
+        sum += LookupSwitch(key);
+    return sum;
+}
+
+long SumTable(const std::vector<int>& keys)
+{
+    long sum = 0;
+    for (int key : keys)
+        sum += Table::Get(key,0);
+    return sum;
+}
+
+} // namespace
+
+int main()
+{
+    const std::size_t n = sizeof(Keys) / sizeof(Keys[0]);
+    std::vector<int> keys(Count);
+    std::uint32_t x = 12345;
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        x = x * 1103515245u + 12345u;
+        keys[i] = (x >> 8) % 4 == 0 ? static_cast<int>((x >> 12) % 0x800)
+            : Keys[(x >> 12) % n];
+    }
+
+    long sumSwitch = 0, sumTable = 0;
+    const double lookupSwitch = NsPerLookup([&]
+        { sumSwitch = SumSwitch(keys); });
+    const double lookupTable = NsPerLookup([&]
+        { sumTable = SumTable(keys); });
+    const bool same = sumSwitch == sumTable;
+
+    std::printf("switch            %8.3f ns/lookup\n",lookupSwitch);
+    std::printf("StaticHashTable   %8.3f ns/lookup (%d keys, %d slots)\n",
+        lookupTable,int(Table::size),int(Table::slots));
+    std::printf("results %s\n",same ? "match" : "DIFFER");
+
+    return same ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+/* {{{ LICENSE
+ * cacheLine.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_CACHELINE_H
+#define DEA_CACHELINE_H
+
+/** @file cacheLine.h
+ * Defines the cache line size used to keep shared data apart.
+ */
+
+/*! \def DEA_CACHE_LINE_SIZE
+ * Size of a cache line in bytes. Define it before including cDea to
+ * match your target, e.g. 128 on CPUs that prefetch line pairs.
+ */
+#ifndef DEA_CACHE_LINE_SIZE
+#define DEA_CACHE_LINE_SIZE 64
+#endif
+
+#endif
@@ -0,0 +1,260 @@
+/* {{{ LICENSE
+ * cpuDispatch.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_CPUDISPATCH_H
+#define DEA_CPUDISPATCH_H
+
+// {{{ Includes
+#include "nullType.h"
+#include "typelist.h"
+
+#include <atomic>
+// }}} Includes
+
+/*! \def DEA_TARGET
+ * Compiles a function for an instruction set the rest of the program is
+ * not built for, e.g. \c DEA_TARGET("avx2"). Empty on compilers without
+ * \c __attribute__((target)).
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DEA_TARGET(isa) __attribute__((target(isa)))
+#else
+#define DEA_TARGET(isa)
+#endif
+
+namespace dea
+{
+
+// {{{ enum CpuFeature
+/*!
+ * Instruction set extensions a kernel can require, combined as a bit
+ * mask.
+ */
+enum CpuFeature : unsigned int
+{
+    CpuNone     = 0,
+    CpuSse42    = 1u << 0,
+    CpuPopcnt   = 1u << 1,
+    CpuAvx      = 1u << 2,
+    CpuAvx2     = 1u << 3,
+    CpuFma      = 1u << 4,
+    CpuBmi2     = 1u << 5,
+    CpuAvx512F  = 1u << 6,
+    CpuAvx512BW = 1u << 7,
+    CpuSse2     = 1u << 8
+};
+// }}} enum CpuFeature
+
+// {{{ class CpuFeatures
+/*! \class dea::CpuFeatures
+ * The instruction set extensions of the running CPU.
+ *
+ * \c Get probes once and caches the result. \c Override replaces it, so
+ * tests can take every path of a dea::CpuDispatch on one machine.
+ */
+class CpuFeatures
+{
+    public:
+        /**
+         * The probed features, or the override if one is set.
+         */
+        static unsigned int Get()
+        {
+            const unsigned int forced =
+                Forced().load(std::memory_order_relaxed);
+            if (forced != Unset)
+                return forced;
+            static const unsigned int probed = Probe();
+            return probed;
+        }
+
+        /**
+         * Makes \c Get return \c features until \c Reset.
+         */
+        static void Override(unsigned int features)
+        { Forced().store(features,std::memory_order_relaxed); }
+        static void Reset()
+        { Forced().store(Unset,std::memory_order_relaxed); }
+
+        /**
+         * Asks the CPU, without caching.
+         */
+        static unsigned int Probe()
+        {
+            unsigned int features = CpuNone;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+            __builtin_cpu_init();
+            // also checks that the OS saves the wider registers
+            if (__builtin_cpu_supports("sse2"))     features |= CpuSse2;
+            if (__builtin_cpu_supports("sse4.2"))   features |= CpuSse42;
+            if (__builtin_cpu_supports("popcnt"))   features |= CpuPopcnt;
+            if (__builtin_cpu_supports("avx"))      features |= CpuAvx;
+            if (__builtin_cpu_supports("avx2"))     features |= CpuAvx2;
+            if (__builtin_cpu_supports("fma"))      features |= CpuFma;
+            if (__builtin_cpu_supports("bmi2"))     features |= CpuBmi2;
+            if (__builtin_cpu_supports("avx512f"))  features |= CpuAvx512F;
+            if (__builtin_cpu_supports("avx512bw")) features |= CpuAvx512BW;
+#endif
+            return features;
+        }
+
+    private:
+        static const unsigned int Unset = ~0u;
+
+        static std::atomic<unsigned int>& Forced()
+        {
+            static std::atomic<unsigned int> forced{Unset};
+            return forced;
+        }
+};
+// }}} class CpuFeatures
+
+// {{{ class CpuDispatch
+/*! \class dea::CpuDispatch
+ * Calls the best kernel of a dea::Typelist the CPU supports.
+ *
+ * Every kernel names the dea::CpuFeature bits it needs in
+ * \c enum { required = ... } and implements a static \c Run with the
+ * dispatched signature. The list is ordered by preference and has to
+ * end with a kernel that needs nothing.
+ *
+ * The first \c Call probes the CPU and stores the chosen \c Run in a
+ * function pointer; from then on a call is one load and one indirect
+ * call.
+ *
+ * Example:
+ * \code
+ * struct SumAvx2
+ * {
+ *     enum { required = dea::CpuAvx2 };
+ *     DEA_TARGET("avx2") static int Run(const int* p, std::size_t n);
+ * };
+ * struct SumSse42 { enum { required = dea::CpuSse42 }; ... };
+ * struct SumScalar { enum { required = dea::CpuNone }; ... };
+ *
+ * typedef dea::CpuDispatch<int(const int*,std::size_t),
+ *      typename dea::TL::MakeTypelist<SumAvx2,SumSse42,SumScalar>::Result>
+ *      Sum;
+ *
+ * int s = Sum::Call(data,n);
+ * \endcode
+ *
+ * \tparam Signature Function type of the kernels
+ * \tparam TList dea::Typelist of kernels, best first
+ */
+template <typename Signature, typename TList> class CpuDispatch;
+template <typename R, typename... Args, typename TList>
+class CpuDispatch<R(Args...),TList>
+{
+    public:
+        typedef R (*Function)(Args...);
+
+    private:
+        template <typename L> struct Last;
+        template <typename Head>
+        struct Last<Typelist<Head,NullType>>
+        {
+            typedef Head Result;
+        };
+        template <typename Head, typename Tail>
+        struct Last<Typelist<Head,Tail>>
+        {
+            typedef typename Last<Tail>::Result Result;
+        };
+
+        static_assert(
+            static_cast<unsigned int>(Last<TList>::Result::required) == 0,
+            "CpuDispatch needs a fallback kernel that requires nothing");
+
+        template <typename L, int index = 0> struct Select;
+        template <typename Head, typename Tail, int index>
+        struct Select<Typelist<Head,Tail>,index>
+        {
+            static Function Do(unsigned int features, int& chosen)
+            {
+                const unsigned int needs = Head::required;
+                if ((features & needs) == needs)
+                {
+                    chosen = index;
+                    return &Head::Run;
+                }
+                return Select<Tail,index+1>::Do(features,chosen);
+            }
+        };
+        template <int index>
+        struct Select<NullType,index>
+        {
+            static Function Do(unsigned int, int&) { return nullptr; }
+        };
+
+        static std::atomic<Function> slot_;
+        static std::atomic<int> chosen_;
+
+    public:
+        /**
+         * Calls the selected kernel.
+         */
+        static R Call(Args... args)
+        {
+            return slot_.load(std::memory_order_relaxed)(
+                static_cast<Args>(args)...);
+        }
+
+        /**
+         * Selects the kernel for \c features right away, e.g. the ones
+         * of a different CPU in a test.
+         */
+        static void Resolve(unsigned int features)
+        {
+            int chosen = -1;
+            const Function function = Select<TList>::Do(features,chosen);
+            chosen_.store(chosen,std::memory_order_relaxed);
+            slot_.store(function,std::memory_order_relaxed);
+        }
+        /**
+         * Selects the kernel for dea::CpuFeatures::Get().
+         */
+        static void Resolve() { Resolve(CpuFeatures::Get()); }
+
+        /**
+         * Index of the selected kernel in the typelist, -1 before the
+         * first call.
+         */
+        static int Selected()
+        { return chosen_.load(std::memory_order_relaxed); }
+
+    private:
+        static R FirstCall(Args... args)
+        {
+            Resolve();
+            return Call(static_cast<Args>(args)...);
+        }
+};
+template <typename R, typename... Args, typename TList>
+std::atomic<typename CpuDispatch<R(Args...),TList>::Function>
+    CpuDispatch<R(Args...),TList>::slot_{
+        &CpuDispatch<R(Args...),TList>::FirstCall};
+template <typename R, typename... Args, typename TList>
+std::atomic<int> CpuDispatch<R(Args...),TList>::chosen_{-1};
+// }}} class CpuDispatch
+
+} // namespace: dea
+
+#endif
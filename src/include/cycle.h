@@ -21,23 +21,161 @@
 #ifndef DEA_CYCLE_H
 #define DEA_CYCLE_H
 
+#include "typemap.h"
+
+#include <limits>
 #include <memory>
+#include <type_traits>
+
+/*! \def DEA_CXX14_CONSTEXPR
+ * Expands to \c constexpr if the compiler supports C++14 relaxed
+ * constexpr functions, so mutating operations are usable in constant
+ * expressions where possible.
+ */
+#if __cplusplus >= 201402L
+#define DEA_CXX14_CONSTEXPR constexpr
+#else
+#define DEA_CXX14_CONSTEXPR
+#endif
 
 namespace dea
 {
 
+// floor(log2(r)), for the shift of power of two ranges
+constexpr unsigned int CycleLog2(unsigned long long r)
+{ return r <= 1 ? 0 : 1 + CycleLog2(r >> 1); }
+
+// {{{ struct CycleWrap
+/*! \struct dea::CycleWrap
+ * Wraps a value into the closed range [Min,Max] in constant time.
+ *
+ * If \c Min is 0 and the range is a power of two the wrap is a single
+ * mask, otherwise it is one division. Both report the number of wraps,
+ * positive when wrapping over \c Max and negative when wrapping under
+ * \c Min.
+ *
+ * If [Min,Max] covers all values of \c T, \c Range does not fit into
+ * \c T and is 0. Such a value never leaves the range, so nothing is
+ * wrapped and the number of wraps is always 0.
+ *
+ * \tparam T Value type
+ * \tparam Min Lower bound
+ * \tparam Max Upper bound
+ */
 template<typename T,T Min,T Max>
-class StaticStdOverload
+struct CycleWrap
 {
+    private:
+        // distances are taken in the unsigned counterpart of T, where
+        // they cannot overflow, like in dea::DynamicCycleWrap
+        typedef typename std::make_unsigned<T>::type U;
+
     public:
-        virtual ~StaticStdOverload() noexcept = default;
+    enum
+    {
+        isFull = Min == std::numeric_limits<T>::min() &&
+                 Max == std::numeric_limits<T>::max()
+    };
+
+    static constexpr T Range = isFull ? T(0) : T(U(Max)-U(Min)+1);
+
+    enum
+    {
+        isMask = !isFull && Min == 0 && (Range & (Range-1)) == 0,
+        shift  = isMask ? CycleLog2(Range) : 0
+    };
+
+    /**
+     * Wraps \c t into [Min,Max] and returns the number of wraps.
+     */
+    static DEA_CXX14_CONSTEXPR long int Wrap(T& t)
+    { return Wrap(t,Method()); }
+
+    /**
+     * Wraps \c t only if it is greater than \c Max and returns the
+     * number of wraps.
+     */
+    static DEA_CXX14_CONSTEXPR long int WrapMax(T& t)
+    { return t > Max ? Wrap(t,Method()) : 0; }
+
+    /**
+     * Returns \c t wrapped into [Min,Max].
+     * Usable in C++11 constant expressions.
+     */
+    static constexpr T Wrapped(T t)
+    { return Wrapped(t,Method()); }
+
+    private:
+        // 0: division, 1: mask, 2: full range, nothing to wrap
+        typedef Int2Type<isFull ? 2 : isMask ? 1 : 0> Method;
+        static constexpr U span = U(Range);
+
+        static constexpr T Wrapped(T t,Int2Type<2>)
+        { return t; }
+        static constexpr T Wrapped(T t,Int2Type<1>)
+        { return t & (Range-1); }
+        static constexpr T Wrapped(T t,Int2Type<0>)
+        {
+            return t > Max ? T(U(t) - ((U(t)-U(Max)-1) / span + 1) * span)
+                 : t < Min ? T(U(t) + ((U(Min)-U(t)-1) / span + 1) * span)
+                 : t;
+        }
+
+        static DEA_CXX14_CONSTEXPR long int Wrap(T&,Int2Type<2>)
+        { return 0; }
+        static DEA_CXX14_CONSTEXPR long int Wrap(T& t,Int2Type<1>)
+        {
+            const long int wraps = Floor(t,Int2Type<std::is_signed<T>::value>());
+            t &= (Range-1);
+            return wraps;
+        }
+        static DEA_CXX14_CONSTEXPR long int Wrap(T& t,Int2Type<0>)
+        {
+            if (t > Max)
+            {
+                const U q = (U(t)-U(Max)-1) / span + 1;
+                t = T(U(t) - q * span);
+                return static_cast<long int>(q);
+            }
+            if (t < Min)
+            {
+                const U q = (U(Min)-U(t)-1) / span + 1;
+                t = T(U(t) + q * span);
+                return -static_cast<long int>(q);
+            }
+            return 0;
+        }
+
+        // floor(t/Range) for power of two ranges, rounding towards
+        // negative infinity for signed types
+        static constexpr long int Floor(T t,Int2Type<true>)
+        { return t < 0 ? -static_cast<long int>((-(t+1)) >> shift) - 1
+                       : t >> shift; }
+        static constexpr long int Floor(T t,Int2Type<false>)
+        { return t >> shift; }
+};
+template<typename T,T Min,T Max>
+constexpr T CycleWrap<T,Min,Max>::Range;
+template<typename T,T Min,T Max>
+constexpr typename CycleWrap<T,Min,Max>::U CycleWrap<T,Min,Max>::span;
+// }}} struct CycleWrap
+
+/*! \class dea::StaticStdOverload
+ * Wraps a dea::StaticCycle into its range in both directions.
+ *
+ * The destructor is protected and not virtual, which keeps the
+ * dea::StaticCycle using it a literal type. Delete a cycle through its
+ * own type, never through this policy.
+ */
+template<typename T,T Min,T Max>
+class StaticStdOverload
+{
     protected:
-        static const T Overload(T& t)
+        ~StaticStdOverload() noexcept = default;
+
+        static DEA_CXX14_CONSTEXPR const T Overload(T& t)
         {
-            while (t > Max)
-                t -= (Max+1-Min);
-            while (t < Min)
-                t += (Max+1-Min);
+            CycleWrap<T,Min,Max>::Wrap(t);
             return t;
         };
 };
@@ -49,22 +187,14 @@ class StaticCountStdOverload
 
     public:
         virtual ~StaticCountStdOverload() noexcept = default;
-        setCounter(const std::shared_ptr<long int>& counter)
+        void setCounter(const std::shared_ptr<long int>& counter)
             { counter_ = counter; }
 
     protected:
         const T Overload(T& t)
         {
-            while (t > Max)
-            {
-                t -= (Max+1-Min);
-                if (counter_) ++(*counter_);
-            }
-            while (t < Min)
-            {
-                t += (Max+1-Min);
-                if (counter_) --(*counter_);
-            }
+            const long int wraps = CycleWrap<T,Min,Max>::Wrap(t);
+            if (counter_) *counter_ += wraps;
             return t;
         };
 };
@@ -76,21 +206,39 @@ class StaticCountMaxOverload
 
     public:
         virtual ~StaticCountMaxOverload() noexcept = default;
-        setCounter(const std::shared_ptr<size_t>& counter)
+        void setCounter(const std::shared_ptr<size_t>& counter)
             { counter_ = counter; }
 
     protected:
         const T Overload(T& t)
         {
-            while (t > Max)
-            {
-                t -= (Max+1-Min);
-                if (counter_) ++(*counter_);
-            }
+            const long int wraps = CycleWrap<T,Min,Max>::WrapMax(t);
+            if (counter_) *counter_ += wraps;
             return t;
         };
 };
 
+// {{{ struct OverloadWrapsOnlyMax
+/*! \struct dea::OverloadWrapsOnlyMax
+ * Tells whether an overload policy only wraps values over \c Max, like
+ * dea::StaticCountMaxOverload. Specialize it for your own policies of
+ * that kind.
+ *
+ * \tparam T Value type
+ * \tparam OnOverload Overload policy
+ */
+template<typename T,template <typename,T,T> class OnOverload>
+struct OverloadWrapsOnlyMax
+{
+    enum { value = false };
+};
+template<typename T>
+struct OverloadWrapsOnlyMax<T,StaticCountMaxOverload>
+{
+    enum { value = true };
+};
+// }}} struct OverloadWrapsOnlyMax
+
 template<typename T,T Min,T Max,T Step,
     template <typename,T,T> class OnOverload=StaticStdOverload>
 class StaticCycle final : public OnOverload <T,Min,Max>
@@ -99,26 +247,31 @@ class StaticCycle final : public OnOverload <T,Min,Max>
     T value_;
 
     public:
+        typedef T ValueType;
+        static constexpr T minValue  = Min;
+        static constexpr T maxValue  = Max;
+        static constexpr T stepValue = Step;
+
         StaticCycle() = default;
         template<typename... Args>
-        StaticCycle(Args... args);
-        StaticCycle(const StaticCycle&);
-        StaticCycle(StaticCycle&&);
+        constexpr StaticCycle(Args... args);
+        constexpr StaticCycle(const StaticCycle&);
+        constexpr StaticCycle(StaticCycle&&);
         template <typename U>
-        StaticCycle& operator=(U&&);
-        StaticCycle& operator=(const StaticCycle&);
-        StaticCycle& operator=(StaticCycle&&);
-        ~StaticCycle() noexcept;
-
-        const T operator()() const { return value_; }
-        StaticCycle& operator++();
-        StaticCycle& operator--();
-        StaticCycle& operator++(int);
-        StaticCycle& operator--(int);
+        DEA_CXX14_CONSTEXPR StaticCycle& operator=(U&&);
+        DEA_CXX14_CONSTEXPR StaticCycle& operator=(const StaticCycle&);
+        DEA_CXX14_CONSTEXPR StaticCycle& operator=(StaticCycle&&);
+        ~StaticCycle() noexcept = default;
+
+        constexpr const T operator()() const { return value_; }
+        DEA_CXX14_CONSTEXPR StaticCycle& operator++();
+        DEA_CXX14_CONSTEXPR StaticCycle& operator--();
+        DEA_CXX14_CONSTEXPR StaticCycle operator++(int);
+        DEA_CXX14_CONSTEXPR StaticCycle operator--(int);
         template <typename U>
-        StaticCycle& operator+=(U&& rhs);
+        DEA_CXX14_CONSTEXPR StaticCycle& operator+=(U&& rhs);
         template <typename U>
-        StaticCycle& operator-=(U&& rhs);
+        DEA_CXX14_CONSTEXPR StaticCycle& operator-=(U&& rhs);
 
         /**
          * Does NOT swap OnOverload members
@@ -130,85 +283,85 @@ class StaticCycle final : public OnOverload <T,Min,Max>
 };
 
 template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
-template<typename... Args>
-StaticCycle<T,Min,Max,Step,OnOverload>::StaticCycle (Args... args)
-    : OnOverload<T,Min,Max>{},value_{args...}
-{
-    Base::Overload(value_);
-}
+constexpr T StaticCycle<T,Min,Max,Step,OnOverload>::minValue;
+template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
+constexpr T StaticCycle<T,Min,Max,Step,OnOverload>::maxValue;
+template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
+constexpr T StaticCycle<T,Min,Max,Step,OnOverload>::stepValue;
 
 template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
-StaticCycle<T,Min,Max,Step,OnOverload>::~StaticCycle() noexcept {}
+template<typename... Args>
+constexpr StaticCycle<T,Min,Max,Step,OnOverload>::StaticCycle (Args... args)
+    : OnOverload<T,Min,Max>{},value_{CycleWrap<T,Min,Max>::Wrapped(T{args...})}
+{ }
 
 template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
-StaticCycle<T,Min,Max,Step,OnOverload>::StaticCycle
+constexpr StaticCycle<T,Min,Max,Step,OnOverload>::StaticCycle
     (const StaticCycle<T,Min,Max,Step,OnOverload>& other) 
-    : value_{other.value_}
+    : OnOverload<T,Min,Max>{},value_{other.value_}
 { }
 
 template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
-StaticCycle<T,Min,Max,Step,OnOverload>::StaticCycle
+constexpr StaticCycle<T,Min,Max,Step,OnOverload>::StaticCycle
     (StaticCycle<T,Min,Max,Step,OnOverload>&& other) 
-{
-    swap(*this,other);
-}
+    : OnOverload<T,Min,Max>{},value_{other.value_}
+{ }
 
 template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
 template <typename U>
-StaticCycle<T,Min,Max,Step,OnOverload>&
+DEA_CXX14_CONSTEXPR StaticCycle<T,Min,Max,Step,OnOverload>&
 StaticCycle<T,Min,Max,Step,OnOverload>::operator=(U&& rhs)
 {
     value_ = std::forward<U>(rhs); Base::Overload(value_); return *this;
 }
 
 template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
-StaticCycle<T,Min,Max,Step,OnOverload>&
+DEA_CXX14_CONSTEXPR StaticCycle<T,Min,Max,Step,OnOverload>&
 StaticCycle<T,Min,Max,Step,OnOverload>::operator=
     (const StaticCycle<T,Min,Max,Step,OnOverload>& rhs)
 {
-    auto tmp = rhs;
-    swap(*this,tmp);
+    value_ = rhs.value_;
     return *this;
 }
 
 template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
-StaticCycle<T,Min,Max,Step,OnOverload>&
+DEA_CXX14_CONSTEXPR StaticCycle<T,Min,Max,Step,OnOverload>&
 StaticCycle<T,Min,Max,Step,OnOverload>::operator=
     (StaticCycle<T,Min,Max,Step,OnOverload>&& rhs)
 {
-    swap(*this,rhs);
+    value_ = rhs.value_;
     return *this;
 }
 
 template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
-StaticCycle<T,Min,Max,Step,OnOverload>&
+DEA_CXX14_CONSTEXPR StaticCycle<T,Min,Max,Step,OnOverload>&
 StaticCycle<T,Min,Max,Step,OnOverload>::operator++()
 {
     value_+=Step; Base::Overload(value_); return *this;
 }
 template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
-StaticCycle<T,Min,Max,Step,OnOverload>&
+DEA_CXX14_CONSTEXPR StaticCycle<T,Min,Max,Step,OnOverload>&
 StaticCycle<T,Min,Max,Step,OnOverload>::operator--()
 {
     value_-=Step; Base::Overload(value_); return *this;
 }
 template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
-StaticCycle<T,Min,Max,Step,OnOverload>&
+DEA_CXX14_CONSTEXPR StaticCycle<T,Min,Max,Step,OnOverload>
 StaticCycle<T,Min,Max,Step,OnOverload>::operator++(int)
 {
-    auto tmp{*this};
-    value_+=Step; Base::Overload(value_); return *tmp;
+    StaticCycle tmp{*this};
+    value_+=Step; Base::Overload(value_); return tmp;
 }
 template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
-StaticCycle<T,Min,Max,Step,OnOverload>&
+DEA_CXX14_CONSTEXPR StaticCycle<T,Min,Max,Step,OnOverload>
 StaticCycle<T,Min,Max,Step,OnOverload>::operator--(int)
 {
-    auto tmp{*this};
-    value_-=Step; Base::Overload(value_); return *tmp;
+    StaticCycle tmp{*this};
+    value_-=Step; Base::Overload(value_); return tmp;
 }
 template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
 template <typename U>
-StaticCycle<T,Min,Max,Step,OnOverload>&
+DEA_CXX14_CONSTEXPR StaticCycle<T,Min,Max,Step,OnOverload>&
 StaticCycle<T,Min,Max,Step,OnOverload>::operator+=(U&& rhs)
 {
     value_+=std::forward<U>(rhs); Base::Overload(value_);
@@ -216,15 +369,13 @@ StaticCycle<T,Min,Max,Step,OnOverload>::operator+=(U&& rhs)
 }
 template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
 template <typename U>
-StaticCycle<T,Min,Max,Step,OnOverload>&
+DEA_CXX14_CONSTEXPR StaticCycle<T,Min,Max,Step,OnOverload>&
 StaticCycle<T,Min,Max,Step,OnOverload>::operator-=(U&& rhs)
 {
-    value_=std::forward<U>(rhs); Base::Overload(value_);
+    value_-=std::forward<U>(rhs); Base::Overload(value_);
     return *this;
 }
 
-
-
 } // namespace: dea
 
 #endif
@@ -0,0 +1,233 @@
+/* {{{ LICENSE
+ * cycleBatch.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_CYCLEBATCH_H
+#define DEA_CYCLEBATCH_H
+
+// {{{ Includes
+#include "cycle.h"
+#include "typemap.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ struct CycleBatchKernel
+/*! \struct dea::CycleBatchKernel
+ * Adds an already reduced offset to a span of cycle values.
+ *
+ * Every value has to lie in [Min,Max] and \c d in [0,Range), so each
+ * value wraps at most once: values greater than \c lim get \c sub
+ * subtracted, all others get \c d added.
+ * Returns the number of values that wrapped.
+ *
+ * 32 bit integers use the SSE2 or AVX2 kernel the translation unit is
+ * compiled for, every other type uses the scalar loop.
+ *
+ * \tparam T Value type
+ * \tparam simd Whether to use the vector kernel
+ */
+template <typename T, bool simd>
+struct CycleBatchKernel
+{
+    static long int Add(T* values, std::size_t n, T d, T lim, T sub)
+    {
+        long int wraps = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const bool over = values[i] > lim;
+            values[i] = over ? values[i] - sub : values[i] + d;
+            wraps += over;
+        }
+        return wraps;
+    }
+};
+#if defined(__SSE2__)
+template <typename T>
+struct CycleBatchKernel<T,true>
+{
+    static long int Add(T* values, std::size_t n, T d, T lim, T sub)
+    {
+        // unsigned values are compared signed after flipping the sign bit
+        const std::int32_t bias = std::is_signed<T>::value ? 0 : INT32_MIN;
+        const std::int32_t blim = static_cast<std::int32_t>(lim) ^ bias;
+        std::size_t i = 0;
+        long int wraps = 0;
+
+#if defined(__AVX2__)
+        {
+            const __m256i vbias = _mm256_set1_epi32(bias);
+            const __m256i vlim  = _mm256_set1_epi32(blim);
+            const __m256i vd    = _mm256_set1_epi32(d);
+            const __m256i vsub  = _mm256_set1_epi32(sub);
+            __m256i acc = _mm256_setzero_si256();
+            for (; i + 8 <= n; i += 8)
+            {
+                __m256i* p = reinterpret_cast<__m256i*>(values + i);
+                const __m256i v = _mm256_loadu_si256(p);
+                const __m256i over = _mm256_cmpgt_epi32(
+                        _mm256_xor_si256(v,vbias),vlim);
+                const __m256i off = _mm256_blendv_epi8(vd,
+                        _mm256_sub_epi32(_mm256_setzero_si256(),vsub),over);
+                _mm256_storeu_si256(p,_mm256_add_epi32(v,off));
+                acc = _mm256_sub_epi32(acc,over);
+            }
+            alignas(32) std::int32_t lanes[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes),acc);
+            for (int l = 0; l < 8; ++l) wraps += lanes[l];
+        }
+#endif
+        {
+            const __m128i vbias = _mm_set1_epi32(bias);
+            const __m128i vlim  = _mm_set1_epi32(blim);
+            const __m128i vd    = _mm_set1_epi32(d);
+            const __m128i vsub  = _mm_set1_epi32(sub);
+            __m128i acc = _mm_setzero_si128();
+            for (; i + 4 <= n; i += 4)
+            {
+                __m128i* p = reinterpret_cast<__m128i*>(values + i);
+                const __m128i v = _mm_loadu_si128(p);
+                const __m128i over = _mm_cmpgt_epi32(
+                        _mm_xor_si128(v,vbias),vlim);
+                const __m128i off = _mm_or_si128(
+                        _mm_andnot_si128(over,vd),
+                        _mm_and_si128(over,
+                            _mm_sub_epi32(_mm_setzero_si128(),vsub)));
+                _mm_storeu_si128(p,_mm_add_epi32(v,off));
+                acc = _mm_sub_epi32(acc,over);
+            }
+            alignas(16) std::int32_t lanes[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes),acc);
+            for (int l = 0; l < 4; ++l) wraps += lanes[l];
+        }
+
+        return wraps + CycleBatchKernel<T,false>::Add(values+i,n-i,d,lim,sub);
+    }
+};
+#endif
+// }}} struct CycleBatchKernel
+
+// {{{ struct CycleBatch
+/*! \struct dea::CycleBatch
+ * Batch operations on contiguous spans of values of a dea::StaticCycle.
+ *
+ * The spans hold the plain values (as returned by \c cycle()), not
+ * dea::StaticCycle objects. Every value passed to \c Add or \c Advance has
+ * to lie in [Min,Max] already; use \c Wrap for arbitrary values.
+ *
+ * All operations follow the overload policy of the cycle and return the
+ * number of wraps, which the counting policies add to their counter.
+ * Policies that only wrap over \c Max, like dea::StaticCountMaxOverload,
+ * still keep values added a negative delta in [Min,Max], but do not
+ * count wraps under \c Min. Cycles over every value of \c T never wrap
+ * and report 0 wraps.
+ *
+ * \code
+ * typedef dea::StaticCycle<int,0,99,1,dea::StaticCountStdOverload> Phase;
+ * *counter += dea::CycleBatch<Phase>::Add(phases.data(),phases.size(),7);
+ * \endcode
+ *
+ * \tparam Cycle dea::StaticCycle whose values are stored in the spans
+ */
+template <typename Cycle> struct CycleBatch;
+template<typename T,T Min,T Max,T Step,template<typename,T,T> class OnOverload>
+struct CycleBatch<StaticCycle<T,Min,Max,Step,OnOverload>>
+{
+    private:
+        typedef CycleWrap<T,Min,Max> Wrapper;
+        typedef CycleWrap<T,0,T(Wrapper::Range-1)> Reducer;
+        typedef typename Select<std::is_integral<T>::value,
+            std::make_unsigned<T>,std::common_type<T>>::Result::type Unsigned;
+
+        enum
+        {
+            onlyMax = OverloadWrapsOnlyMax<T,OnOverload>::value,
+            simd = std::is_integral<T>::value && sizeof(T) == 4,
+            // 0: wrap both ways, 1: count only wraps over Max,
+            // 2: full range, nothing to wrap
+            method = Wrapper::isFull ? 2 : onlyMax ? 1 : 0
+        };
+
+        static long int Add(T* values, std::size_t n, T delta, Int2Type<2>)
+        {
+            // the values wrap around T itself, without signed overflow
+            for (std::size_t i = 0; i < n; ++i)
+                values[i] = static_cast<T>(static_cast<Unsigned>(values[i])
+                    + static_cast<Unsigned>(delta));
+            return 0;
+        }
+        static long int Add(T* values, std::size_t n, T delta, Int2Type<1>)
+        {
+            // wraps under Min keep the values in range, but do not count
+            const long int wraps = Add(values,n,delta,Int2Type<0>());
+            return delta < T() ? 0 : wraps;
+        }
+        static long int Add(T* values, std::size_t n, T delta, Int2Type<0>)
+        {
+            const long int q = Reducer::Wrap(delta);
+            return q * static_cast<long int>(n) +
+                CycleBatchKernel<T,simd>::Add(values,n,delta,
+                    Max-delta,Wrapper::Range-delta);
+        }
+
+    public:
+        /**
+         * Adds \c delta to every value and wraps them.
+         * Costs one division for the whole span.
+         * Returns the number of wraps.
+         */
+        static long int Add(T* values, std::size_t n, T delta)
+        { return Add(values,n,delta,Int2Type<method>()); }
+
+        /**
+         * Advances every value by \c Step.
+         * Returns the number of wraps.
+         */
+        static long int Advance(T* values, std::size_t n)
+        { return Add(values,n,Step); }
+
+        /**
+         * Wraps arbitrary values into [Min,Max].
+         * Returns the number of wraps.
+         */
+        static long int Wrap(T* values, std::size_t n)
+        {
+            long int wraps = 0;
+            for (std::size_t i = 0; i < n; ++i)
+                wraps += onlyMax ? Wrapper::WrapMax(values[i])
+                                 : Wrapper::Wrap(values[i]);
+            return wraps;
+        }
+};
+// }}} struct CycleBatch
+
+} // namespace: dea
+
+#endif
@@ -0,0 +1,202 @@
+/* {{{ LICENSE
+ * cycleCounter.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_CYCLECOUNTER_H
+#define DEA_CYCLECOUNTER_H
+
+// {{{ Includes
+#include "cacheLine.h"
+#include "cycle.h"
+
+#include <atomic>
+#include <memory>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ class AtomicCounter
+/*! \class dea::AtomicCounter
+ * A wrap counter that may be shared between threads.
+ *
+ * Increments are relaxed atomics and the counter is padded so that its
+ * value has a cache line to itself, also when allocated on the heap.
+ */
+class AtomicCounter
+{
+    // padded instead of aligned, std::make_shared ignores extended
+    // alignment before C++17. With a line of padding in front and the
+    // rest of a line behind, nothing else shares the value's line
+    // wherever the counter lands.
+    char before_[DEA_CACHE_LINE_SIZE];
+    std::atomic<long int> value_ = {0};
+    char after_[DEA_CACHE_LINE_SIZE - sizeof(std::atomic<long int>)];
+
+    public:
+        void Add(long int n)
+            { value_.fetch_add(n,std::memory_order_relaxed); }
+        long int Load() const
+            { return value_.load(std::memory_order_relaxed); }
+};
+// }}} class AtomicCounter
+
+// {{{ class ShardedCounter
+/*! \class dea::ShardedCounter
+ * A wrap counter split into per-thread shards.
+ *
+ * Every thread adds to its own cache line, so threads that wrap at the
+ * same time do not contend. Reading sums up all shards and is therefore
+ * more expensive than adding.
+ *
+ * \tparam shards Number of shards. Threads are assigned round-robin, so
+ * more threads than shards share shards, which stays correct.
+ */
+template <unsigned int shards = 64>
+class ShardedCounter
+{
+    static_assert(shards > 0,"ShardedCounter needs at least one shard");
+
+    // padded instead of aligned like dea::AtomicCounter: shards one
+    // line apart never share a line, the leading padding keeps the
+    // first one apart from whatever precedes the counter
+    struct Shard
+    {
+        std::atomic<long int> value_ = {0};
+        char padding_[DEA_CACHE_LINE_SIZE - sizeof(std::atomic<long int>)];
+    };
+
+    char before_[DEA_CACHE_LINE_SIZE];
+    Shard shards_[shards];
+
+    public:
+        void Add(long int n)
+        {
+            shards_[ThreadIndex() % shards].value_.fetch_add(n,
+                std::memory_order_relaxed);
+        }
+        long int Load() const
+        {
+            long int sum = 0;
+            for (const Shard& shard : shards_)
+                sum += shard.value_.load(std::memory_order_relaxed);
+            return sum;
+        }
+
+    private:
+        static unsigned int ThreadIndex()
+        {
+            static std::atomic<unsigned int> next = {0};
+            static thread_local const unsigned int index =
+                next.fetch_add(1,std::memory_order_relaxed);
+            return index;
+        }
+};
+// }}} class ShardedCounter
+
+// {{{ Overload policies
+/*! \class dea::StaticSharedCountStdOverload
+ * Like dea::StaticCountStdOverload, but adds the wraps to a counter
+ * that many threads may share, e.g. dea::AtomicCounter or
+ * dea::ShardedCounter. Steps without a wrap do not touch the counter.
+ *
+ * Use dea::StaticAtomicCountStdOverload or
+ * dea::StaticShardedCountStdOverload as the policy of a
+ * dea::StaticCycle.
+ *
+ * \tparam Counter Counter type providing \c Add(long int)
+ */
+template<typename Counter,typename T,T Min,T Max>
+class StaticSharedCountStdOverload
+{
+    std::shared_ptr<Counter> counter_ = {nullptr};
+
+    public:
+        virtual ~StaticSharedCountStdOverload() noexcept = default;
+        void setCounter(const std::shared_ptr<Counter>& counter)
+            { counter_ = counter; }
+
+    protected:
+        const T Overload(T& t)
+        {
+            const long int wraps = CycleWrap<T,Min,Max>::Wrap(t);
+            if (wraps && counter_) counter_->Add(wraps);
+            return t;
+        };
+};
+
+/*! \class dea::StaticSharedCountMaxOverload
+ * Like dea::StaticCountMaxOverload, but adds the wraps to a counter
+ * that many threads may share.
+ *
+ * \tparam Counter Counter type providing \c Add(long int)
+ */
+template<typename Counter,typename T,T Min,T Max>
+class StaticSharedCountMaxOverload
+{
+    std::shared_ptr<Counter> counter_ = {nullptr};
+
+    public:
+        virtual ~StaticSharedCountMaxOverload() noexcept = default;
+        void setCounter(const std::shared_ptr<Counter>& counter)
+            { counter_ = counter; }
+
+    protected:
+        const T Overload(T& t)
+        {
+            const long int wraps = CycleWrap<T,Min,Max>::WrapMax(t);
+            if (wraps && counter_) counter_->Add(wraps);
+            return t;
+        };
+};
+
+template<typename T,T Min,T Max>
+class StaticAtomicCountStdOverload
+    : public StaticSharedCountStdOverload<AtomicCounter,T,Min,Max>
+{};
+
+template<typename T,T Min,T Max>
+class StaticAtomicCountMaxOverload
+    : public StaticSharedCountMaxOverload<AtomicCounter,T,Min,Max>
+{};
+
+template<typename T,T Min,T Max>
+class StaticShardedCountStdOverload
+    : public StaticSharedCountStdOverload<ShardedCounter<>,T,Min,Max>
+{};
+
+template<typename T,T Min,T Max>
+class StaticShardedCountMaxOverload
+    : public StaticSharedCountMaxOverload<ShardedCounter<>,T,Min,Max>
+{};
+template<typename T>
+struct OverloadWrapsOnlyMax<T,StaticAtomicCountMaxOverload>
+{
+    enum { value = true };
+};
+template<typename T>
+struct OverloadWrapsOnlyMax<T,StaticShardedCountMaxOverload>
+{
+    enum { value = true };
+};
+// }}} Overload policies
+
+} // namespace: dea
+
+#endif
@@ -0,0 +1,129 @@
+/* {{{ LICENSE
+ * cycleTable.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_CYCLETABLE_H
+#define DEA_CYCLETABLE_H
+
+// {{{ Includes
+#include "cycle.h"
+#include "typemap.h"
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ struct CycleWalk
+/*! \struct dea::CycleWalk
+ * Computes the values a dea::StaticCycle walks through in constant
+ * expressions.
+ *
+ * \c dea::CycleWalk<Cycle>::At(start,i) is the value after stepping
+ * \c i times from \c start, without iterating and without overflowing
+ * for large \c i.
+ *
+ * Only the constructors and \c operator() of a dea::StaticCycle are
+ * constexpr in C++11, its mutating operators need C++14 (see
+ * DEA_CXX14_CONSTEXPR). The walk is therefore computed here in closed
+ * form instead of by stepping a cycle, so tables work in C++11 too.
+ *
+ * \tparam Cycle dea::StaticCycle to walk
+ */
+template <typename Cycle>
+struct CycleWalk
+{
+    typedef typename Cycle::ValueType ValueType;
+
+    static constexpr long long Range =
+        static_cast<long long>(Cycle::maxValue) - Cycle::minValue + 1;
+
+    /**
+     * Value after \c i steps starting at \c start.
+     */
+    static constexpr ValueType At(ValueType start, unsigned long long i)
+    {
+        return static_cast<ValueType>(Cycle::minValue +
+            static_cast<long long>((Offset(start) +
+                MulMod(i % Range,Mod(Cycle::stepValue),Range)) % Range));
+    }
+
+    private:
+        static constexpr unsigned long long Mod(long long t)
+        { return static_cast<unsigned long long>((t % Range + Range) % Range); }
+
+        static constexpr unsigned long long Offset(ValueType start)
+        { return Mod(static_cast<long long>(start) - Cycle::minValue); }
+
+        static constexpr unsigned long long MulMod(unsigned long long a,
+            unsigned long long b, unsigned long long m)
+        { return b == 0 ? 0 : (2 * MulMod(a,b/2,m) + (b%2) * a) % m; }
+};
+template <typename Cycle>
+constexpr long long CycleWalk<Cycle>::Range;
+// }}} struct CycleWalk
+
+// {{{ struct CycleTable
+/*! \struct dea::CycleTable
+ * Expands a walk of a dea::StaticCycle into a static constexpr array at
+ * compile time, so the table lives in read-only data and costs nothing
+ * at startup.
+ *
+ * Example:
+ * \code
+ * typedef dea::StaticCycle<int,0,15,5> Scramble;
+ * typedef dea::CycleTable<Scramble,16> Permutation;
+ *
+ * static_assert(Permutation::values[1] == 5,"");
+ * int x = Permutation::values[i];
+ * \endcode
+ *
+ * \tparam Cycle dea::StaticCycle to walk
+ * \tparam n Number of values
+ * \tparam start First value of the walk, defaults to \c Min
+ */
+template <typename Cycle, typename Cycle::ValueType start, typename Indices>
+struct CycleTableHelper;
+template <typename Cycle, typename Cycle::ValueType start, unsigned int... i>
+struct CycleTableHelper<Cycle,start,IndexSequence<i...>>
+{
+    typedef typename Cycle::ValueType ValueType;
+
+    enum { size = sizeof...(i) /*!< Number of values.*/ };
+
+    /**
+     * The values of the walk.
+     */
+    static constexpr ValueType values[sizeof...(i)] =
+        { CycleWalk<Cycle>::At(start,i)... };
+};
+template <typename Cycle, typename Cycle::ValueType start, unsigned int... i>
+constexpr typename Cycle::ValueType
+CycleTableHelper<Cycle,start,IndexSequence<i...>>::values[sizeof...(i)];
+
+template <typename Cycle, unsigned int n,
+    typename Cycle::ValueType start = Cycle::minValue>
+struct CycleTable
+    : public CycleTableHelper<Cycle,start,
+        typename MakeIndexSequence<n>::Result>
+{};
+// }}} struct CycleTable
+
+} // namespace: dea
+
+#endif
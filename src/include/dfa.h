@@ -0,0 +1,693 @@
+/* {{{ LICENSE
+ * dfa.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_DFA_H
+#define DEA_DFA_H
+
+// {{{ Includes
+#include "nullType.h"
+#include "typelist.h"
+#include "typemap.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ Character classes
+/*! \struct dea::DfaChars
+ * The bytes \c c... as the label of a dea::DfaEdge.
+ */
+template <char... c> struct DfaChars;
+template <>
+struct DfaChars<>
+{
+    static constexpr bool Contains(unsigned int) { return false; }
+};
+template <char head, char... tail>
+struct DfaChars<head,tail...>
+{
+    static constexpr bool Contains(unsigned int b)
+    {
+        return b == static_cast<unsigned char>(head) ||
+            DfaChars<tail...>::Contains(b);
+    }
+};
+
+/*! \struct dea::DfaRange
+ * The bytes from \c lo to \c hi, both included.
+ */
+template <char lo, char hi>
+struct DfaRange
+{
+    static constexpr bool Contains(unsigned int b)
+    {
+        return b >= static_cast<unsigned char>(lo) &&
+            b <= static_cast<unsigned char>(hi);
+    }
+};
+
+/*! \struct dea::DfaAny
+ * Every byte.
+ */
+struct DfaAny
+{
+    static constexpr bool Contains(unsigned int) { return true; }
+};
+
+/*! \struct dea::DfaNot
+ * Every byte that is not in the class \c C.
+ */
+template <typename C>
+struct DfaNot
+{
+    static constexpr bool Contains(unsigned int b)
+    { return !C::Contains(b); }
+};
+// }}} Character classes
+
+// {{{ struct DfaEdge
+/*! \struct dea::DfaEdge
+ * A transition of a dea::Dfa from state \c From to state \c To on every
+ * byte of the character class \c Chars.
+ */
+template <typename From, typename Chars, typename To>
+struct DfaEdge
+{
+    typedef From FromState;
+    typedef Chars CharClass;
+    typedef To ToState;
+};
+// }}} struct DfaEdge
+
+// {{{ struct DfaArray
+/*! \struct dea::DfaArray
+ * A static constexpr array of \c Gen::Size() values \c Gen::At(i),
+ * computed at compile time.
+ */
+template <typename T, typename Gen, typename Indices>
+struct DfaArrayHelper;
+template <typename T, typename Gen, unsigned int... i>
+struct DfaArrayHelper<T,Gen,IndexSequence<i...>>
+{
+    static constexpr T values[sizeof...(i)] = { Gen::At(i)... };
+};
+template <typename T, typename Gen, unsigned int... i>
+constexpr T DfaArrayHelper<T,Gen,IndexSequence<i...>>::values[sizeof...(i)];
+
+template <typename T, typename Gen>
+struct DfaArray
+    : public DfaArrayHelper<T,Gen,
+        typename MakeIndexSequence<Gen::Size()>::Result>
+{};
+// }}} struct DfaArray
+
+// {{{ struct DfaTarget
+// The first edge out of state `from` that contains byte `b` wins.
+template <typename States, typename Edges> struct DfaTarget;
+template <typename States>
+struct DfaTarget<States,NullType>
+{
+    static constexpr int At(int, unsigned int) { return -1; }
+    static constexpr bool Boundary(unsigned int) { return false; }
+};
+template <typename States, typename From, typename Chars, typename To,
+    typename Tail>
+struct DfaTarget<States,Typelist<DfaEdge<From,Chars,To>,Tail>>
+{
+    static_assert(TL::IndexOf<States,From>::value != -1,
+        "Dfa: edge from a state that is not in the state list");
+    static_assert(TL::IndexOf<States,To>::value != -1,
+        "Dfa: edge to a state that is not in the state list");
+
+    static constexpr int At(int from, unsigned int b)
+    {
+        return from == TL::IndexOf<States,From>::value && Chars::Contains(b)
+            ? TL::IndexOf<States,To>::value
+            : DfaTarget<States,Tail>::At(from,b);
+    }
+
+    // does some class start or end at byte b?
+    static constexpr bool Boundary(unsigned int b)
+    {
+        return Chars::Contains(b) != Chars::Contains(b-1) ||
+            DfaTarget<States,Tail>::Boundary(b);
+    }
+};
+// }}} struct DfaTarget
+
+// {{{ struct DfaAccepting
+template <typename States, typename Accepting> struct DfaAccepting;
+template <typename Accepting>
+struct DfaAccepting<NullType,Accepting>
+{
+    static constexpr bool At(unsigned int) { return false; }
+};
+template <typename Head, typename Tail, typename Accepting>
+struct DfaAccepting<Typelist<Head,Tail>,Accepting>
+{
+    static constexpr bool At(unsigned int i)
+    {
+        return i == 0 ? TL::IndexOf<Accepting,Head>::value != -1
+            : DfaAccepting<Tail,Accepting>::At(i-1);
+    }
+};
+// }}} struct DfaAccepting
+
+// {{{ Table generators
+template <typename Spec>
+struct DfaBoundaryGen
+{
+    static constexpr unsigned int Size() { return 256; }
+    static constexpr bool At(unsigned int b)
+    { return b != 0 && Spec::Edges::Boundary(b); }
+};
+
+// Bytes between two boundaries behave the same on every edge, so they
+// share one column of the transition table.
+template <typename Spec>
+struct DfaClassGen
+{
+    static constexpr unsigned int Size() { return 256; }
+    static constexpr unsigned int At(unsigned int b) { return Count(1,b+1); }
+
+    private:
+        static constexpr unsigned int Count(unsigned int lo, unsigned int hi)
+        {
+            return hi <= lo ? 0 : hi - lo == 1
+                ? Spec::Boundaries::values[lo]
+                : Count(lo,(lo+hi)/2) + Count((lo+hi)/2,hi);
+        }
+};
+
+// number of bytes that leave state i
+template <typename Spec>
+struct DfaExitGen
+{
+    static constexpr unsigned int Size() { return Spec::states; }
+    static constexpr unsigned int At(unsigned int i) { return Count(i,0,256); }
+
+    private:
+        static constexpr unsigned int Count(unsigned int i, unsigned int lo,
+            unsigned int hi)
+        {
+            return hi - lo == 1
+                ? Spec::Edges::At(i,lo) != static_cast<int>(i)
+                : Count(i,lo,(lo+hi)/2) + Count(i,(lo+hi)/2,hi);
+        }
+};
+
+// position of state i in the table: the dead state, accepting states,
+// other accelerated states, the rest
+template <typename Spec>
+struct DfaRankGen
+{
+    static constexpr unsigned int Size() { return Spec::states; }
+    static constexpr unsigned int At(unsigned int i)
+    { return 1 + Before(i,0); }
+
+    private:
+        static constexpr unsigned int Before(unsigned int i, unsigned int j)
+        {
+            return j == Spec::states ? 0 :
+                (Spec::Kind(j) < Spec::Kind(i) ||
+                    (Spec::Kind(j) == Spec::Kind(i) && j < i)) +
+                Before(i,j+1);
+        }
+};
+
+// state index of every table row, -1 for the dead state
+template <typename Spec>
+struct DfaOrderGen
+{
+    static constexpr unsigned int Size() { return Spec::states + 1; }
+    static constexpr int At(unsigned int row)
+    { return row == 0 ? -1 : Find(row,0); }
+
+    private:
+        static constexpr int Find(unsigned int row, unsigned int i)
+        {
+            return Spec::Ranks::values[i] == row ? static_cast<int>(i)
+                : Find(row,i+1);
+        }
+};
+
+// rows of premultiplied next states, one column per byte class
+template <typename Spec, typename StateId>
+struct DfaTableGen
+{
+    static constexpr unsigned int Size()
+    { return (Spec::states + 1) * Spec::Classes(); }
+    static constexpr StateId At(unsigned int j)
+    {
+        return Next(Spec::Order::values[j / Spec::Classes()],
+            First(j % Spec::Classes(),0,256));
+    }
+
+    private:
+        static constexpr StateId Next(int from, unsigned int b)
+        { return from < 0 ? 0 : Id(Spec::Edges::At(from,b)); }
+        static constexpr StateId Id(int to)
+        {
+            return to < 0 ? 0 : static_cast<StateId>(
+                Spec::Ranks::values[to] * Spec::Classes());
+        }
+        // the first byte of a class
+        static constexpr unsigned int First(unsigned int k, unsigned int lo,
+            unsigned int hi)
+        {
+            return lo == hi ? lo
+                : Spec::ByteClasses::values[(lo+hi)/2] < k
+                    ? First(k,(lo+hi)/2+1,hi)
+                    : First(k,lo,(lo+hi)/2);
+        }
+};
+
+// the state two bytes later, one column per pair of classes, with rows
+// premultiplied by the number of columns
+template <typename Spec, typename Table, typename PairId, bool build>
+struct DfaPairGen
+{
+    static constexpr unsigned int Size()
+    {
+        return build ? (Spec::states + 1) * Spec::Classes() * Spec::Classes()
+            : 1;
+    }
+    static constexpr PairId At(unsigned int j)
+    {
+        return static_cast<PairId>(Table::values[
+            Table::values[j / Spec::Classes()] + j % Spec::Classes()] *
+            Spec::Classes());
+    }
+};
+
+// number of exit bytes of every row, -1 if the row is not accelerated
+template <typename Spec>
+struct DfaRowExitGen
+{
+    static constexpr unsigned int Size() { return Spec::states + 1; }
+    static constexpr int At(unsigned int row)
+    {
+        return row == 0 || !Spec::Accelerated(Spec::Order::values[row]) ? -1
+            : static_cast<int>(Spec::Exits::values[Spec::Order::values[row]]);
+    }
+};
+
+// the exit bytes of accelerated rows, padded with the first one
+template <typename Spec>
+struct DfaRowExitByteGen
+{
+    static constexpr unsigned int Size()
+    { return (Spec::states + 1) * Spec::maxExits; }
+    static constexpr unsigned int At(unsigned int j)
+    {
+        return Byte(Spec::Order::values[j / Spec::maxExits],
+            j % Spec::maxExits);
+    }
+
+    private:
+        static constexpr unsigned int Byte(int i, unsigned int k)
+        {
+            return i < 0 || !Spec::Accelerated(i) ||
+                Spec::Exits::values[i] == 0
+                ? 0 : Find(i,k < Spec::Exits::values[i] ? k : 0,0);
+        }
+        static constexpr unsigned int Find(int i, unsigned int k,
+            unsigned int b)
+        {
+            return Spec::Edges::At(i,b) == i ? Find(i,k,b+1)
+                : k == 0 ? b : Find(i,k-1,b+1);
+        }
+};
+// }}} Table generators
+
+// {{{ struct DfaSpec
+template <typename States, typename Accepting, typename EdgeList>
+struct DfaSpec
+{
+    enum
+    {
+        states = TL::Length<States>::value,
+        maxExits = 3
+    };
+
+    typedef DfaTarget<States,EdgeList> Edges;
+    typedef DfaArray<bool,DfaBoundaryGen<DfaSpec>> Boundaries;
+    typedef DfaArray<unsigned char,DfaClassGen<DfaSpec>> ByteClasses;
+    typedef DfaArray<unsigned short,DfaExitGen<DfaSpec>> Exits;
+    typedef DfaArray<unsigned int,DfaRankGen<DfaSpec>> Ranks;
+    typedef DfaArray<int,DfaOrderGen<DfaSpec>> Order;
+    typedef DfaArray<signed char,DfaRowExitGen<DfaSpec>> RowExits;
+    typedef DfaArray<unsigned char,DfaRowExitByteGen<DfaSpec>> RowExitBytes;
+
+    static constexpr unsigned int Classes()
+    { return ByteClasses::values[255] + 1u; }
+
+    static constexpr bool Accelerated(int i)
+    { return Exits::values[i] <= maxExits; }
+    // 0: accepting, 1: accelerated, 2: other
+    static constexpr unsigned int Kind(int i)
+    {
+        return DfaAccepting<States,Accepting>::At(i) ? 0
+            : Accelerated(i) ? 1 : 2;
+    }
+    static constexpr unsigned int Count(unsigned int kind, unsigned int i)
+    { return i == states ? 0 : (Kind(i) == kind) + Count(kind,i+1); }
+};
+// }}} struct DfaSpec
+
+// {{{ class Dfa
+/*! \class dea::Dfa
+ * A deterministic finite automaton declared with typelists and compiled
+ * into a flat transition table.
+ *
+ * States are arbitrary tag types; the first one of \c States is the
+ * start state. Transitions are dea::DfaEdge types labelled with a
+ * character class. The first edge out of a state that contains a byte
+ * is taken, so a trailing dea::DfaAny edge works as a default. Bytes
+ * without an edge lead into an implicit dead state.
+ *
+ * Example, decimal numbers with an optional fraction:
+ * \code
+ * struct Begin; struct Int; struct Dot; struct Frac;
+ * typedef dea::DfaRange<'0','9'> Digit;
+ *
+ * typedef dea::Dfa<
+ *      typename dea::TL::MakeTypelist<Begin,Int,Dot,Frac>::Result,
+ *      typename dea::TL::MakeTypelist<Int,Frac>::Result,
+ *      typename dea::TL::MakeTypelist<
+ *          dea::DfaEdge<Begin,Digit,Int>,
+ *          dea::DfaEdge<Int,Digit,Int>,
+ *          dea::DfaEdge<Int,dea::DfaChars<'.'>,Dot>,
+ *          dea::DfaEdge<Dot,Digit,Frac>,
+ *          dea::DfaEdge<Frac,Digit,Frac>>::Result> Number;
+ *
+ * bool ok = Number::Match(text,size);
+ * std::ptrdiff_t token = Number::Prefix(text,size);  // -1: no number
+ * \endcode
+ *
+ * The bytes are split into classes that no edge tells apart, and the
+ * table has one column per class instead of 256. Its entries are
+ * premultiplied row offsets, so a step is two loads and an add:
+ * \code
+ * state = table[state + byteClass[byte]];
+ * \endcode
+ * \c Run and \c Match step two bytes at a time through a second table
+ * with one column per pair of classes, as long as it has at most 4096
+ * entries.
+ *
+ * The dead state, the accepting states and the accelerated states get
+ * the lowest ids, so the scan loop tells them all apart from the rest
+ * with one compare. A state is accelerated if at most three bytes leave
+ * it; the scan then jumps to the next of those bytes with \c memchr or
+ * eight bytes at a time instead of stepping through the table. Once the
+ * automaton is dead the rest of the input is skipped.
+ *
+ * \tparam States dea::Typelist of state tags, start state first
+ * \tparam Accepting dea::Typelist of the accepting states
+ * \tparam Edges dea::Typelist of dea::DfaEdge
+ */
+template <typename States, typename Accepting, typename Edges>
+class Dfa
+{
+    static_assert(TL::Length<States>::value > 0,"Dfa needs a state");
+    static_assert(TL::Length<States>::value ==
+        TL::Length<typename TL::NoDuplicates<States>::Result>::value,
+        "Dfa needs distinct states");
+
+    typedef DfaSpec<States,Accepting,Edges> Spec;
+
+    static_assert(Spec::Count(0,0) == TL::Length<Accepting>::value,
+        "Dfa: accepting state that is not in the state list");
+
+    public:
+        enum
+        {
+            states = Spec::states,      /*!< Number of states.*/
+            classes = Spec::Classes()   /*!< Number of byte classes.*/
+        };
+
+        /**
+         * A state, the offset of its row in the transition table.
+         */
+        typedef typename Select<(states * classes < 0x100),std::uint8_t,
+            typename Select<(states * classes < 0x10000),std::uint16_t,
+                std::uint32_t>::Result>::Result StateId;
+
+    private:
+        typedef DfaArray<StateId,DfaTableGen<Spec,StateId>> Table;
+
+        enum
+        {
+            acceptEnd = (1 + Spec::Count(0,0)) * classes,
+            special = (1 + Spec::Count(0,0) + Spec::Count(1,0)) * classes,
+            // small enough to stay in the L1 cache next to Table
+            pairs = (states + 1) * classes * classes <= 4096
+        };
+
+        typedef typename Select<(states * classes * classes < 0x10000),
+            std::uint16_t,std::uint32_t>::Result PairId;
+        typedef DfaArray<PairId,DfaPairGen<Spec,Table,PairId,pairs>> Pairs;
+
+    public:
+        static StateId Start() { return State(0); }
+        static StateId Dead() { return 0; }
+
+        /**
+         * The state at \c index of \c States.
+         */
+        static StateId State(unsigned int index)
+        {
+            return static_cast<StateId>(
+                Spec::Ranks::values[index] * classes);
+        }
+        /**
+         * The state \c S.
+         */
+        template <typename S>
+        static StateId State()
+        {
+            static_assert(TL::IndexOf<States,S>::value != -1,
+                "Dfa: not a state of this automaton");
+            return State(TL::IndexOf<States,S>::value);
+        }
+        /**
+         * Index of \c state in \c States, -1 for the dead state.
+         */
+        static int Index(StateId state)
+        { return Spec::Order::values[state / classes]; }
+
+        static bool IsDead(StateId state) { return state == 0; }
+        static bool IsAccepting(StateId state)
+        { return state != 0 && state < acceptEnd; }
+
+        /**
+         * The state after reading \c byte in \c state.
+         */
+        static StateId Next(StateId state, unsigned char byte)
+        {
+            return Table::values[state +
+                Spec::ByteClasses::values[byte]];
+        }
+
+        /**
+         * Reads [begin,end) starting in \c state and returns the state
+         * it ends in. Stops early once the automaton is dead.
+         */
+        static StateId Run(StateId state, const char* begin,
+            const char* end)
+        {
+            Ignore ignore;
+            const unsigned char* u = Bytes(begin);
+            const unsigned char* last = Bytes(end);
+            std::size_t s = state;
+            if (pairs)
+            {
+                // Two bytes per load halve the chain of dependent loads.
+                // States passed in between are not looked at, which only
+                // costs a skip now and then.
+                std::size_t p = s * classes;
+                while (last - u >= 2)
+                {
+                    if (p < special * classes)
+                    {
+                        if (p == 0)
+                            return 0;
+                        const unsigned char* next =
+                            Skip<false>(p / classes,u,last,ignore);
+                        if (next != u)
+                        {
+                            u = next;
+                            continue;
+                        }
+                    }
+                    p = Pairs::values[p +
+                        Spec::ByteClasses::values[u[0]] * classes +
+                        Spec::ByteClasses::values[u[1]]];
+                    u += 2;
+                }
+                s = p / classes;
+            }
+            return Feed<false>(static_cast<StateId>(s),u,last,ignore);
+        }
+
+        /**
+         * Whether the automaton accepts all of \c data.
+         */
+        static bool Match(const char* data, std::size_t size)
+        { return IsAccepting(Run(Start(),data,data + size)); }
+
+        /**
+         * Length of the longest prefix of \c data the automaton accepts,
+         * -1 if it accepts none.
+         */
+        static std::ptrdiff_t Prefix(const char* data, std::size_t size)
+        {
+            const unsigned char* begin = Bytes(data);
+            const unsigned char* last = IsAccepting(Start()) ? begin : nullptr;
+            Last mark{last};
+            Feed<false>(Start(),begin,begin + size,mark);
+            return last ? last - begin : -1;
+        }
+
+        /**
+         * Reads [begin,end) starting in \c state and calls
+         * \c match(const char* position) after every byte that leaves
+         * the automaton in an accepting state. Returns the state it ends
+         * in.
+         */
+        template <typename F>
+        static StateId Scan(StateId state, const char* begin,
+            const char* end, F&& match)
+        {
+            Report<F> report{match};
+            return Feed<true>(state,Bytes(begin),Bytes(end),report);
+        }
+
+    private:
+        struct Ignore
+        {
+            void operator()(const unsigned char*) const {}
+        };
+        struct Last
+        {
+            const unsigned char*& last;
+            void operator()(const unsigned char* u) const { last = u; }
+        };
+        template <typename F>
+        struct Report
+        {
+            F& f;
+            void operator()(const unsigned char* u) const
+            { f(reinterpret_cast<const char*>(u)); }
+        };
+
+        static const unsigned char* Bytes(const char* p)
+        { return reinterpret_cast<const unsigned char*>(p); }
+
+        // With everyMatch accepting states are not skipped, so `accept`
+        // sees every accepting position.
+        template <bool everyMatch, typename F>
+        static StateId Feed(StateId state, const unsigned char* u,
+            const unsigned char* end, F& accept)
+        {
+            // a full-width copy saves extending the state every step
+            std::size_t s = state;
+            if (s < special)
+            {
+                if (s == 0)
+                    return 0;
+                u = Skip<everyMatch>(s,u,end,accept);
+            }
+            while (u != end)
+            {
+                s = Table::values[s + Spec::ByteClasses::values[*u++]];
+                if (s < special)
+                {
+                    if (s == 0)
+                        return 0;
+                    if (s < acceptEnd)
+                        accept(u);
+                    u = Skip<everyMatch>(s,u,end,accept);
+                }
+            }
+            return static_cast<StateId>(s);
+        }
+
+        template <bool everyMatch, typename F>
+        static const unsigned char* Skip(std::size_t state,
+            const unsigned char* u, const unsigned char* end, F& accept)
+        {
+            const unsigned int row = state / classes;
+            const int exits = Spec::RowExits::values[row];
+            if (exits < 0 || (everyMatch && state < acceptEnd) || u == end)
+                return u;
+            const unsigned char* bytes =
+                &Spec::RowExitBytes::values[row * Spec::maxExits];
+            const unsigned char* next;
+            if (exits == 0)
+                next = end;
+            else if (exits == 1)
+            {
+                const void* hit = std::memchr(u,bytes[0],end - u);
+                next = hit ? static_cast<const unsigned char*>(hit) : end;
+            }
+            else
+                next = FindAny(bytes,u,end);
+            // every skipped byte kept the automaton in this state
+            if (state < acceptEnd && next != u)
+                accept(next);
+            return next;
+        }
+
+        static const unsigned char* FindAny(const unsigned char* bytes,
+            const unsigned char* u, const unsigned char* end)
+        {
+            const std::uint64_t ones = 0x0101010101010101ull;
+            const std::uint64_t highs = ones * 0x80;
+            const std::uint64_t a = ones * bytes[0];
+            const std::uint64_t b = ones * bytes[1];
+            const std::uint64_t c = ones * bytes[2];
+            for (; end - u >= 8; u += 8)
+            {
+                std::uint64_t word;
+                std::memcpy(&word,u,sizeof word);
+                const std::uint64_t x = word ^ a;
+                const std::uint64_t y = word ^ b;
+                const std::uint64_t z = word ^ c;
+                // non-zero if one of x, y, z has a zero byte
+                if ((((x - ones) & ~x) | ((y - ones) & ~y) |
+                        ((z - ones) & ~z)) & highs)
+                    break;
+            }
+            for (; u != end; ++u)
+                if (*u == bytes[0] || *u == bytes[1] || *u == bytes[2])
+                    return u;
+            return end;
+        }
+};
+// }}} class Dfa
+
+} // namespace: dea
+
+#endif
@@ -0,0 +1,361 @@
+/* {{{ LICENSE
+ * dynamicCycle.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_DYNAMICCYCLE_H
+#define DEA_DYNAMICCYCLE_H
+
+// {{{ Includes
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ class FastDivider
+/*! \class dea::FastDivider
+ * Divides by a divisor only known at runtime without a hardware divide.
+ *
+ * For unsigned types of up to 32 bits the quotient is computed with a
+ * precomputed 64 bit reciprocal: one multiplication and one shift.
+ * Wider types, or compilers without 128 bit integers, fall back to the
+ * plain division.
+ *
+ * \tparam U Unsigned integer type
+ */
+#if defined(__SIZEOF_INT128__)
+template <typename U, bool fast = sizeof(U) <= 4>
+#else
+template <typename U, bool fast = false>
+#endif
+class FastDivider
+{
+    U d_;
+
+    public:
+        explicit FastDivider(U d = 1) : d_{d} {}
+
+        U Divide(U a) const { return a / d_; }
+        U Divisor() const { return d_; }
+};
+#if defined(__SIZEOF_INT128__)
+template <typename U>
+class FastDivider<U,true>
+{
+    // __extension__ keeps -Wpedantic quiet about the non-ISO type
+    __extension__ typedef unsigned __int128 Wide;
+
+    std::uint64_t m_;
+    std::uint32_t d_;
+
+    public:
+        explicit FastDivider(U d = 1)
+            : m_{UINT64_C(0xFFFFFFFFFFFFFFFF) / d + 1},d_{d}
+        {}
+
+        U Divide(U a) const
+        {
+            // the reciprocal of 1 overflows to 0
+            return d_ == 1 ? a : static_cast<U>(
+                (static_cast<Wide>(m_) * a) >> 64);
+        }
+        U Divisor() const { return d_; }
+};
+#endif
+// }}} class FastDivider
+
+// {{{ class DynamicCycleWrap
+/*! \class dea::DynamicCycleWrap
+ * Wraps values into the closed range [min,max] given at runtime.
+ *
+ * The runtime counterpart of dea::CycleWrap. Values within one range of
+ * the bounds wrap with a single subtraction, all others use a
+ * dea::FastDivider prepared at construction.
+ *
+ * If [min,max] covers every value of \c T, the range does not fit into
+ * \c U and \c Range() is 0. Values then never wrap and \c Wrap
+ * returns 0.
+ *
+ * \tparam T Value type
+ */
+template <typename T>
+class DynamicCycleWrap
+{
+    typedef typename std::make_unsigned<T>::type U;
+
+    T min_;
+    T max_;
+    U range_;
+    FastDivider<U> divider_;
+
+    public:
+        /**
+         * \throws std::invalid_argument if \c min is greater than \c max
+         */
+        DynamicCycleWrap(T min, T max)
+            : min_{min},max_{max},range_{static_cast<U>(U(max)-U(min)+1)}
+            // a full range is 0 and is never divided by
+            , divider_{range_ != 0 ? range_ : U(1)}
+        {
+            if (max < min)
+                throw std::invalid_argument("DynamicCycleWrap: min > max");
+        }
+
+        T Min() const { return min_; }
+        T Max() const { return max_; }
+        U Range() const { return range_; }
+
+        /**
+         * Wraps \c t into [min,max] and returns the number of wraps.
+         */
+        long int Wrap(T& t) const
+        {
+            if (t > max_)
+                return Over(t);
+            if (t < min_)
+            {
+                const U q = Quotient(U(min_)-U(t)-1) + 1;
+                t = static_cast<T>(U(t) + q * range_);
+                return -static_cast<long int>(q);
+            }
+            return 0;
+        }
+
+        /**
+         * Wraps \c t only if it is greater than \c max and returns the
+         * number of wraps.
+         */
+        long int WrapMax(T& t) const
+        { return t > max_ ? Over(t) : 0; }
+
+    private:
+        long int Over(T& t) const
+        {
+            const U q = Quotient(U(t)-U(max_)-1) + 1;
+            t = static_cast<T>(U(t) - q * range_);
+            return static_cast<long int>(q);
+        }
+
+        U Quotient(U d) const
+        { return d < range_ ? 0 : divider_.Divide(d); }
+};
+// }}} class DynamicCycleWrap
+
+// {{{ Overload policies
+/*! \class dea::DynamicStdOverload
+ * Wraps a dea::DynamicCycle into its range in both directions.
+ */
+template <typename T>
+class DynamicStdOverload
+{
+    protected:
+        ~DynamicStdOverload() noexcept = default;
+
+        static const T Overload(T& t,const DynamicCycleWrap<T>& wrap)
+        {
+            wrap.Wrap(t);
+            return t;
+        };
+};
+
+/*! \class dea::DynamicCountStdOverload
+ * Like dea::DynamicStdOverload and counts the wraps, positive over max,
+ * negative under min.
+ */
+template <typename T>
+class DynamicCountStdOverload
+{
+    std::shared_ptr<long int> counter_ = {nullptr};
+
+    public:
+        virtual ~DynamicCountStdOverload() noexcept = default;
+        void setCounter(const std::shared_ptr<long int>& counter)
+            { counter_ = counter; }
+
+    protected:
+        const T Overload(T& t,const DynamicCycleWrap<T>& wrap)
+        {
+            const long int wraps = wrap.Wrap(t);
+            if (counter_) *counter_ += wraps;
+            return t;
+        };
+};
+
+/*! \class dea::DynamicCountMaxOverload
+ * Wraps a dea::DynamicCycle only over max and counts these wraps.
+ */
+template <typename T>
+class DynamicCountMaxOverload
+{
+    std::shared_ptr<size_t> counter_ = {nullptr};
+
+    public:
+        virtual ~DynamicCountMaxOverload() noexcept = default;
+        void setCounter(const std::shared_ptr<size_t>& counter)
+            { counter_ = counter; }
+
+    protected:
+        const T Overload(T& t,const DynamicCycleWrap<T>& wrap)
+        {
+            const long int wraps = wrap.WrapMax(t);
+            if (counter_) *counter_ += wraps;
+            return t;
+        };
+};
+// }}} Overload policies
+
+// {{{ class DynamicCycle
+/*! \class dea::DynamicCycle
+ * A dea::StaticCycle whose bounds and step are given at runtime.
+ *
+ * Example:
+ * \code
+ * dea::DynamicCycle<unsigned int> slot{0,config.ringSize-1};
+ * slot += offset;
+ * buffer[slot()] = x;
+ * \endcode
+ *
+ * \tparam T Value type
+ * \tparam OnOverload Overload policy, see dea::DynamicStdOverload
+ */
+template <typename T,
+    template <typename> class OnOverload=DynamicStdOverload>
+class DynamicCycle final : public OnOverload<T>
+{
+    typedef OnOverload<T> Base;
+
+    DynamicCycleWrap<T> wrap_;
+    T step_;
+    T value_;
+
+    public:
+        typedef T ValueType;
+
+        /**
+         * \param min Lower bound
+         * \param max Upper bound
+         * \param step Value added by operator++
+         * \param value Initial value, wrapped into [min,max]
+         */
+        DynamicCycle(T min, T max, T step = 1, T value = T());
+        DynamicCycle(const DynamicCycle&);
+        DynamicCycle& operator=(const DynamicCycle&);
+        ~DynamicCycle() noexcept = default;
+
+        template <typename U>
+        DynamicCycle& operator=(U&&);
+
+        const T operator()() const { return value_; }
+        T min() const { return wrap_.Min(); }
+        T max() const { return wrap_.Max(); }
+        T step() const { return step_; }
+
+        DynamicCycle& operator++();
+        DynamicCycle& operator--();
+        DynamicCycle operator++(int);
+        DynamicCycle operator--(int);
+        template <typename U>
+        DynamicCycle& operator+=(U&& rhs);
+        template <typename U>
+        DynamicCycle& operator-=(U&& rhs);
+
+        /**
+         * Does NOT swap OnOverload members
+         */
+        inline friend void swap(DynamicCycle& lhs,DynamicCycle& rhs) noexcept
+        {
+            std::swap(lhs.wrap_,rhs.wrap_);
+            std::swap(lhs.step_,rhs.step_);
+            std::swap(lhs.value_,rhs.value_);
+        }
+};
+
+template <typename T,template <typename> class OnOverload>
+DynamicCycle<T,OnOverload>::DynamicCycle(T min, T max, T step, T value)
+    : OnOverload<T>{},wrap_{min,max},step_{step},value_{value}
+{
+    Base::Overload(value_,wrap_);
+}
+
+template <typename T,template <typename> class OnOverload>
+DynamicCycle<T,OnOverload>::DynamicCycle(const DynamicCycle& other)
+    : OnOverload<T>{},wrap_{other.wrap_},step_{other.step_}
+    , value_{other.value_}
+{ }
+
+template <typename T,template <typename> class OnOverload>
+DynamicCycle<T,OnOverload>&
+DynamicCycle<T,OnOverload>::operator=(const DynamicCycle& rhs)
+{
+    wrap_ = rhs.wrap_; step_ = rhs.step_; value_ = rhs.value_;
+    return *this;
+}
+
+template <typename T,template <typename> class OnOverload>
+template <typename U>
+DynamicCycle<T,OnOverload>&
+DynamicCycle<T,OnOverload>::operator=(U&& rhs)
+{
+    value_ = std::forward<U>(rhs); Base::Overload(value_,wrap_); return *this;
+}
+
+template <typename T,template <typename> class OnOverload>
+DynamicCycle<T,OnOverload>& DynamicCycle<T,OnOverload>::operator++()
+{
+    value_+=step_; Base::Overload(value_,wrap_); return *this;
+}
+template <typename T,template <typename> class OnOverload>
+DynamicCycle<T,OnOverload>& DynamicCycle<T,OnOverload>::operator--()
+{
+    value_-=step_; Base::Overload(value_,wrap_); return *this;
+}
+template <typename T,template <typename> class OnOverload>
+DynamicCycle<T,OnOverload> DynamicCycle<T,OnOverload>::operator++(int)
+{
+    DynamicCycle tmp{*this};
+    value_+=step_; Base::Overload(value_,wrap_); return tmp;
+}
+template <typename T,template <typename> class OnOverload>
+DynamicCycle<T,OnOverload> DynamicCycle<T,OnOverload>::operator--(int)
+{
+    DynamicCycle tmp{*this};
+    value_-=step_; Base::Overload(value_,wrap_); return tmp;
+}
+template <typename T,template <typename> class OnOverload>
+template <typename U>
+DynamicCycle<T,OnOverload>& DynamicCycle<T,OnOverload>::operator+=(U&& rhs)
+{
+    value_+=std::forward<U>(rhs); Base::Overload(value_,wrap_);
+    return *this;
+}
+template <typename T,template <typename> class OnOverload>
+template <typename U>
+DynamicCycle<T,OnOverload>& DynamicCycle<T,OnOverload>::operator-=(U&& rhs)
+{
+    value_-=std::forward<U>(rhs); Base::Overload(value_,wrap_);
+    return *this;
+}
+// }}} class DynamicCycle
+
+} // namespace: dea
+
+#endif
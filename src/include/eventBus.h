@@ -0,0 +1,321 @@
+/* {{{ LICENSE
+ * eventBus.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_EVENTBUS_H
+#define DEA_EVENTBUS_H
+
+// {{{ Includes
+#include "hierarchy.h"
+#include "nullType.h"
+#include "typelist.h"
+#include "typemap.h"
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ class EventChannel
+/*! \class dea::EventChannel
+ * The subscribers and deferred events of one event type of a
+ * dea::EventBus.
+ *
+ * \tparam E Event type
+ */
+template <typename E>
+class EventChannel
+{
+    public:
+        typedef std::function<void(const E&)> Handler;
+        typedef std::function<void(const E*,std::size_t)> BatchHandler;
+
+    private:
+        // Handlers must stay in place while they run, so during a
+        // delivery new ones wait in `added` and removed ones are only
+        // marked; both are settled once the outermost delivery is done.
+        template <typename F>
+        struct List
+        {
+            struct Entry
+            {
+                std::size_t id;
+                F handler;
+                bool active;
+            };
+
+            std::vector<Entry> entries;
+            std::vector<Entry> added;
+
+            void Add(std::size_t id, F handler, bool delivering)
+            {
+                (delivering ? added : entries).push_back(
+                    Entry{id,std::move(handler),true});
+            }
+            bool Remove(std::size_t id)
+            {
+                for (Entry& entry : entries)
+                    if (entry.id == id && entry.active)
+                        return !(entry.active = false);
+                for (Entry& entry : added)
+                    if (entry.id == id && entry.active)
+                        return !(entry.active = false);
+                return false;
+            }
+            void Settle()
+            {
+                std::size_t kept = 0;
+                for (std::size_t i = 0; i < entries.size(); ++i)
+                    if (entries[i].active)
+                        entries[kept++] = std::move(entries[i]);
+                entries.resize(kept);
+                for (Entry& entry : added)
+                    if (entry.active)
+                        entries.push_back(std::move(entry));
+                added.clear();
+            }
+        };
+
+        List<Handler> handlers_;
+        List<BatchHandler> batchHandlers_;
+        std::vector<E> pending_;
+        std::vector<E> flushing_;
+        std::size_t nextId_ = 1;
+        unsigned int delivering_ = 0;
+        bool dirty_ = false;
+        bool inFlush_ = false;
+
+    public:
+        std::size_t Subscribe(Handler handler)
+        {
+            handlers_.Add(nextId_,std::move(handler),delivering_ > 0);
+            dirty_ = dirty_ || delivering_ > 0;
+            return nextId_++;
+        }
+        std::size_t SubscribeBatch(BatchHandler handler)
+        {
+            batchHandlers_.Add(nextId_,std::move(handler),delivering_ > 0);
+            dirty_ = dirty_ || delivering_ > 0;
+            return nextId_++;
+        }
+        bool Unsubscribe(std::size_t id)
+        {
+            if (!handlers_.Remove(id) && !batchHandlers_.Remove(id))
+                return false;
+            dirty_ = true;
+            if (delivering_ == 0)
+                Settle();
+            return true;
+        }
+
+        void Publish(const E& event)
+        {
+            Deliver(&event,1);
+        }
+        template <typename... Args>
+        void Post(Args&&... args)
+        {
+            pending_.emplace_back(std::forward<Args>(args)...);
+        }
+        std::size_t Pending() const { return pending_.size(); }
+
+        /**
+         * Delivers the deferred events. Events posted meanwhile, and a
+         * nested \c Flush from a handler, wait for the next flush.
+         */
+        void Flush()
+        {
+            if (pending_.empty() || inFlush_)
+                return;
+            std::swap(pending_,flushing_);
+            struct Done
+            {
+                EventChannel& channel;
+                ~Done()
+                {
+                    channel.flushing_.clear();
+                    channel.inFlush_ = false;
+                }
+            } done{*this};
+            inFlush_ = true;
+            Deliver(flushing_.data(),flushing_.size());
+        }
+
+    private:
+        void Deliver(const E* events, std::size_t n)
+        {
+            struct Depth
+            {
+                EventChannel& channel;
+                ~Depth()
+                {
+                    if (--channel.delivering_ == 0 && channel.dirty_)
+                        channel.Settle();
+                }
+            } depth{*this};
+            ++delivering_;
+
+            const std::size_t batches = batchHandlers_.entries.size();
+            for (std::size_t i = 0; i < batches; ++i)
+                if (batchHandlers_.entries[i].active)
+                    batchHandlers_.entries[i].handler(events,n);
+            const std::size_t singles = handlers_.entries.size();
+            for (std::size_t e = 0; e < n; ++e)
+                for (std::size_t i = 0; i < singles; ++i)
+                    if (handlers_.entries[i].active)
+                        handlers_.entries[i].handler(events[e]);
+        }
+
+        void Settle()
+        {
+            handlers_.Settle();
+            batchHandlers_.Settle();
+            dirty_ = false;
+        }
+};
+// }}} class EventChannel
+
+// {{{ class EventBus
+/*! \class dea::EventBus
+ * An event bus with one dea::EventChannel per event type, generated with
+ * dea::GenScatterHierarchy.
+ *
+ * \c Publish<E> and \c Subscribe<E> pick the channel of \c E at compile
+ * time; publishing a type that is not in the list does not compile.
+ *
+ * Besides publishing right away, events can be posted. Posted events are
+ * gathered per type in contiguous arrays and delivered by \c Flush, e.g.
+ * once per frame. Batch subscribers get the whole array of a type in one
+ * call.
+ *
+ * Example:
+ * \code
+ * typedef dea::EventBus<typename dea::TL::MakeTypelist<
+ *      KeyPressed,Collision>::Result> Bus;
+ *
+ * Bus bus;
+ * bus.Subscribe<KeyPressed>([](const KeyPressed& e) { ... });
+ * bus.SubscribeBatch<Collision>([](const Collision* c, std::size_t n)
+ *      { physics.Resolve(c,n); });
+ *
+ * bus.Publish(KeyPressed{'q'});
+ * bus.Post<Collision>(Collision{a,b});
+ * bus.Flush();
+ * \endcode
+ *
+ * Handlers may publish, post, subscribe and unsubscribe. The bus is not
+ * thread-safe.
+ *
+ * \tparam TList dea::Typelist of event types, without duplicates
+ */
+template <typename TList>
+class EventBus : public GenScatterHierarchy<TList,EventChannel>
+{
+    static_assert(TL::Length<TList>::value ==
+        TL::Length<typename TL::NoDuplicates<TList>::Result>::value,
+        "EventBus needs distinct event types");
+
+    bool flushing_ = false;
+
+    public:
+        /**
+         * The channel of event type \c E.
+         */
+        template <typename E>
+        EventChannel<E>& Channel()
+        {
+            static_assert(TL::IndexOf<TList,E>::value != -1,
+                "EventBus: not an event type of this bus");
+            return Field<E>(*this);
+        }
+
+        /**
+         * Calls \c handler for every event of type \c E. Returns an id
+         * for \c Unsubscribe.
+         */
+        template <typename E, typename F>
+        std::size_t Subscribe(F&& handler)
+        { return Channel<E>().Subscribe(std::forward<F>(handler)); }
+
+        /**
+         * Calls \c handler with every flushed batch of events of type
+         * \c E. Returns an id for \c Unsubscribe.
+         */
+        template <typename E, typename F>
+        std::size_t SubscribeBatch(F&& handler)
+        { return Channel<E>().SubscribeBatch(std::forward<F>(handler)); }
+
+        template <typename E>
+        bool Unsubscribe(std::size_t id)
+        { return Channel<E>().Unsubscribe(id); }
+
+        /**
+         * Delivers \c event right away.
+         */
+        template <typename E>
+        void Publish(const E& event)
+        { Channel<E>().Publish(event); }
+
+        /**
+         * Constructs an event of type \c E from \c args and keeps it for
+         * the next \c Flush.
+         */
+        template <typename E, typename... Args>
+        void Post(Args&&... args)
+        { Channel<E>().Post(std::forward<Args>(args)...); }
+
+        /**
+         * Delivers every posted event, type by type in the order of the
+         * typelist. Like dea::EventChannel::Flush, a nested \c Flush
+         * from a handler waits for the next flush, so it cannot deliver
+         * later types ahead of the current one.
+         */
+        void Flush()
+        {
+            if (flushing_)
+                return;
+            struct Done
+            {
+                bool& flushing;
+                ~Done() { flushing = false; }
+            } done{flushing_};
+            flushing_ = true;
+            FlushAll(Type2Type<TList>());
+        }
+
+    private:
+        // walks the typelist here rather than with dea::TL::ForEach,
+        // whose header pulls in the thread pool
+        template <typename Head, typename Tail>
+        void FlushAll(Type2Type<Typelist<Head,Tail>>)
+        {
+            Channel<Head>().Flush();
+            FlushAll(Type2Type<Tail>());
+        }
+        void FlushAll(Type2Type<NullType>) {}
+};
+// }}} class EventBus
+
+} // namespace: dea
+
+#endif
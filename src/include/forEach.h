@@ -0,0 +1,157 @@
+/* {{{ LICENSE
+ * forEach.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_FOREACH_H
+#define DEA_FOREACH_H
+
+// {{{ Includes
+#include "hierarchy.h"
+#include "nullType.h"
+#include "threadPool.h"
+#include "typelist.h"
+#include "typemap.h"
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ namespace: TL
+namespace TL
+{
+    // {{{ struct ForEach
+    /*! \struct dea::TL::ForEach
+     * Calls a functor once per type of a dea::Typelist with a
+     * dea::Type2Type of it. The calls are unrolled at compile time.
+     *
+     * \c Parallel runs every call as its own task on a dea::ThreadPool
+     * and returns when all of them are done, so the calls must not
+     * depend on each other.
+     *
+     * Example:
+     * \code
+     * struct BuildIndex
+     * {
+     *     Registry& registry;
+     *     template <typename T>
+     *     void operator()(dea::Type2Type<T>) const
+     *     { registry.Index<T>().Build(); }
+     * };
+     *
+     * dea::TL::ForEach<Components>::Do(BuildIndex{registry});
+     * dea::TL::ForEach<Components>::Parallel(pool,BuildIndex{registry});
+     * \endcode
+     *
+     * \tparam TList dea::Typelist to walk through
+     */
+    template <typename TList> struct ForEach;
+    template <>
+    struct ForEach<NullType>
+    {
+        template <typename F>
+        static void Do(F&&) {}
+        template <typename F>
+        static void Parallel(ThreadPool&, F&&) {}
+        template <typename F>
+        static void Spawn(TaskGroup&, const F&) {}
+    };
+    template <typename Head, typename Tail>
+    struct ForEach<Typelist<Head,Tail>>
+    {
+        template <typename F>
+        static void Do(F&& f)
+        {
+            f(Type2Type<Head>());
+            ForEach<Tail>::Do(f);
+        }
+
+        /**
+         * \throws the first exception thrown by a call
+         */
+        template <typename F>
+        static void Parallel(ThreadPool& pool, F&& f)
+        {
+            TaskGroup group(pool);
+            Spawn(group,f);
+            group.Wait();
+        }
+
+        template <typename F>
+        static void Spawn(TaskGroup& group, const F& f)
+        {
+            group.Run([&f]{ f(Type2Type<Head>()); });
+            ForEach<Tail>::Spawn(group,f);
+        }
+    };
+    // }}} struct ForEach
+}
+// }}} namespace: TL
+
+// {{{ ForEachField
+template <typename TList, unsigned int i = 0,
+    unsigned int n = TL::Length<TList>::value>
+struct ForEachFieldHelper
+{
+    template <typename F>
+    static void Do(Tuple<TList>& tuple, F& f)
+    {
+        f(Field<i>(tuple));
+        ForEachFieldHelper<TList,i+1,n>::Do(tuple,f);
+    }
+    template <typename F>
+    static void Spawn(TaskGroup& group, Tuple<TList>& tuple, const F& f)
+    {
+        group.Run([&tuple,&f]{ f(Field<i>(tuple)); });
+        ForEachFieldHelper<TList,i+1,n>::Spawn(group,tuple,f);
+    }
+};
+template <typename TList, unsigned int n>
+struct ForEachFieldHelper<TList,n,n>
+{
+    template <typename F>
+    static void Do(Tuple<TList>&, F&) {}
+    template <typename F>
+    static void Spawn(TaskGroup&, Tuple<TList>&, const F&) {}
+};
+
+/** \relates dea::Tuple
+ * Calls \c f with every field of \c tuple in order.
+ */
+template <typename TList, typename F>
+void ForEachField(Tuple<TList>& tuple, F&& f)
+{ ForEachFieldHelper<TList>::Do(tuple,f); }
+
+/** \relates dea::Tuple
+ * Calls \c f with every field of \c tuple, each call as its own task on
+ * \c pool, and waits for all of them. Fields are distinct objects, so
+ * this is safe as long as \c f does not touch shared state.
+ * \throws the first exception thrown by a call
+ */
+template <typename TList, typename F>
+void ForEachField(ThreadPool& pool, Tuple<TList>& tuple, F&& f)
+{
+    TaskGroup group(pool);
+    ForEachFieldHelper<TList>::Spawn(group,tuple,f);
+    group.Wait();
+}
+// }}} ForEachField
+
+} // namespace: dea
+
+#endif
@@ -57,14 +57,17 @@ namespace dea
  */
 template <typename TList, template <class> class Unit>
 class GenScatterHierarchy;
+// makes every left base unique, so typelists may hold a type twice
+template <typename T1, typename T2>
+struct ScatterHierarchyTag;
 template <typename T1, typename T2, template <class> class Unit>
 class GenScatterHierarchy<Typelist<T1,T2>,Unit>
-    : public GenScatterHierarchy<T1,Unit>
+    : public GenScatterHierarchy<ScatterHierarchyTag<T1,T2>,Unit>
     , public GenScatterHierarchy<T2,Unit>
 {
     public:
         typedef Typelist<T1,T2> TList;
-        typedef GenScatterHierarchy<T1,Unit> LeftBase;
+        typedef GenScatterHierarchy<ScatterHierarchyTag<T1,T2>,Unit> LeftBase;
         typedef GenScatterHierarchy<T2,Unit> RightBase;
 
         template <typename T>
@@ -84,6 +87,10 @@ class GenScatterHierarchy : public Unit<AtomicType>
         typedef Unit<T> Result;
     };
 };
+template <typename T1, typename T2, template <class> class Unit>
+class GenScatterHierarchy<ScatterHierarchyTag<T1,T2>,Unit>
+    : public GenScatterHierarchy<T1,Unit>
+{};
 template <template <class> class Unit>
 class GenScatterHierarchy<NullType,Unit>
 {};
@@ -181,14 +188,14 @@ struct FieldHelper<H,0>
     
     static ResultType& Do(H& obj)
     {
-        LeftBase leftBase = obj;
+        LeftBase& leftBase = obj;
         return leftBase;
     }
 };
 template <class H, unsigned int i>
 struct FieldHelper
 {
-    typedef typename TL::TypeAt<typename H::Tlist, i>::Result ElementType;
+    typedef typename TL::TypeAt<typename H::TList, i>::Result ElementType;
     typedef typename H::template Rebind<ElementType>::Result UnitType;
 
     enum
@@ -219,6 +226,35 @@ Field(H& obj)
 }
 // }}} typedef Field
 
+// {{{ Tuple comparison
+template <typename TList, unsigned int i = 0,
+    unsigned int n = TL::Length<TList>::value>
+struct TupleEqualHelper
+{
+    static bool Do(const Tuple<TList>& lhs, const Tuple<TList>& rhs)
+    {
+        return Field<i>(lhs) == Field<i>(rhs) &&
+            TupleEqualHelper<TList,i+1,n>::Do(lhs,rhs);
+    }
+};
+template <typename TList, unsigned int n>
+struct TupleEqualHelper<TList,n,n>
+{
+    static bool Do(const Tuple<TList>&, const Tuple<TList>&)
+    { return true; }
+};
+
+/** \relates dea::Tuple
+ * Compares two dea::Tuple instances field by field.
+ */
+template <typename TList>
+bool operator==(const Tuple<TList>& lhs, const Tuple<TList>& rhs)
+{ return TupleEqualHelper<TList>::Do(lhs,rhs); }
+template <typename TList>
+bool operator!=(const Tuple<TList>& lhs, const Tuple<TList>& rhs)
+{ return !(lhs == rhs); }
+// }}} Tuple comparison
+
 // {{{ class GenLinearHiearchy
 // TODO: documentation for GenLinearHiearchy
 template 
@@ -0,0 +1,106 @@
+/* {{{ LICENSE
+ * mappedFile.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_MAPPEDFILE_H
+#define DEA_MAPPEDFILE_H
+
+// {{{ Includes
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ class MappedFile
+/*! \class dea::MappedFile
+ * A whole file mapped read-only into memory.
+ *
+ * Example:
+ * \code
+ * dea::MappedFile log("/var/log/messages");
+ * std::size_t lines = std::count(log.begin(),log.end(),'\n');
+ * \endcode
+ *
+ * \throws std::system_error if the file cannot be opened or mapped
+ */
+class MappedFile
+{
+    void* map_ = MAP_FAILED;
+    std::size_t size_ = 0;
+
+    public:
+        explicit MappedFile(const char* path)
+        {
+            const int fd = ::open(path,O_RDONLY);
+            if (fd < 0)
+                Fail("open");
+            struct stat st;
+            if (::fstat(fd,&st) != 0)
+            {
+                ::close(fd);
+                Fail("fstat");
+            }
+            size_ = static_cast<std::size_t>(st.st_size);
+            // mmap refuses empty mappings
+            if (size_ != 0)
+                map_ = ::mmap(nullptr,size_,PROT_READ,MAP_PRIVATE,fd,0);
+            ::close(fd);
+            if (size_ != 0 && map_ == MAP_FAILED)
+                Fail("mmap");
+            if (size_ != 0)
+                ::madvise(map_,size_,MADV_SEQUENTIAL);
+        }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile() noexcept
+        {
+            if (map_ != MAP_FAILED)
+                ::munmap(map_,size_);
+        }
+
+        const char* Data() const
+        {
+            return map_ == MAP_FAILED ? nullptr
+                : static_cast<const char*>(map_);
+        }
+        std::size_t Size() const { return size_; }
+        const char* begin() const { return Data(); }
+        const char* end() const { return Data() + size_; }
+
+    private:
+        static void Fail(const char* what)
+        {
+            throw std::system_error(errno,std::system_category(),
+                std::string("MappedFile: ") + what);
+        }
+};
+// }}} class MappedFile
+
+} // namespace: dea
+
+#endif
@@ -0,0 +1,279 @@
+/* {{{ LICENSE
+ * memoCache.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_MEMOCACHE_H
+#define DEA_MEMOCACHE_H
+
+// {{{ Includes
+#include "hierarchy.h"
+#include "tupleHash.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ class MemoCache
+/*! \class dea::MemoCache
+ * A bounded least-recently-used cache keyed by dea::Tuple instances.
+ *
+ * Entries live in one flat open addressing table (linear probing, at
+ * most half full) allocated by the constructor; the recency list is
+ * threaded through the table by index. Nothing is allocated after
+ * construction, and erasing shifts the following entries back instead
+ * of leaving tombstones, so lookups stay short under constant eviction.
+ *
+ * Example:
+ * \code
+ * typedef typename dea::TL::MakeTypelist<int,int,Mode>::Result Args;
+ * dea::MemoCache<Args,double> cache(4096);
+ *
+ * dea::Tuple<Args> key;
+ * dea::Field<0>(key) = x;
+ * dea::Field<1>(key) = y;
+ * dea::Field<2>(key) = mode;
+ * double r = cache.Get(key,[](const dea::Tuple<Args>& k)
+ *      { return Expensive(k); });
+ * \endcode
+ *
+ * References and pointers into the cache are invalidated by the next
+ * \c Insert, \c Get or \c Erase. The cache is not thread-safe.
+ *
+ * \tparam TList dea::Typelist of the key fields
+ * \tparam R Cached result, default constructible and move assignable
+ * \tparam HashFn Hash of the key
+ */
+template <typename TList, typename R, typename HashFn = Hash<Tuple<TList>>>
+class MemoCache
+{
+    public:
+        typedef Tuple<TList> Key;
+        typedef R ValueType;
+
+    private:
+        static const std::uint32_t npos = 0xFFFFFFFFu;
+
+        struct Slot
+        {
+            Key key;
+            R value;
+            std::size_t hash = 0;
+            std::uint32_t prev = npos;
+            std::uint32_t next = npos;
+            bool used = false;
+        };
+
+        std::vector<Slot> slots_;
+        std::size_t mask_;
+        std::size_t capacity_;
+        std::size_t size_ = 0;
+        std::uint32_t head_ = npos;     // most recently used
+        std::uint32_t tail_ = npos;     // least recently used
+        HashFn hash_;
+
+    public:
+        /**
+         * \param capacity Maximum number of entries
+         * \throws std::invalid_argument if \c capacity is 0 or above
+         * 2^30
+         */
+        explicit MemoCache(std::size_t capacity, const HashFn& hash = HashFn())
+            : mask_{0},capacity_{capacity},hash_(hash)
+        {
+            if (capacity == 0 || capacity > (std::size_t(1) << 30))
+                throw std::invalid_argument("MemoCache: bad capacity");
+            std::size_t size = 2;
+            while (size < 2 * capacity)
+                size *= 2;
+            slots_.resize(size);
+            mask_ = size - 1;
+        }
+
+        std::size_t Size() const { return size_; }
+        std::size_t Capacity() const { return capacity_; }
+
+        /**
+         * Looks \c key up and marks it as most recently used.
+         * Returns \c nullptr if it is not cached.
+         */
+        R* Find(const Key& key)
+        {
+            const std::uint32_t i = Locate(key,hash_(key));
+            if (i == npos)
+                return nullptr;
+            Touch(i);
+            return &slots_[i].value;
+        }
+
+        /**
+         * Caches \c value for \c key, evicting the least recently used
+         * entry if the cache is full.
+         */
+        R& Insert(const Key& key, R value)
+        {
+            const std::size_t hash = hash_(key);
+            std::uint32_t i = Locate(key,hash);
+            if (i != npos)
+            {
+                slots_[i].value = std::move(value);
+                Touch(i);
+                return slots_[i].value;
+            }
+            if (size_ == capacity_)
+                EraseAt(tail_);
+
+            i = static_cast<std::uint32_t>(hash & mask_);
+            while (slots_[i].used)
+                i = static_cast<std::uint32_t>((i + 1) & mask_);
+            Slot& slot = slots_[i];
+            slot.key = key;
+            slot.value = std::move(value);
+            slot.hash = hash;
+            slot.used = true;
+            PushFront(i);
+            ++size_;
+            return slot.value;
+        }
+
+        /**
+         * Returns the cached result for \c key, computing and caching
+         * \c compute(key) if there is none.
+         */
+        template <typename F>
+        R& Get(const Key& key, F&& compute)
+        {
+            if (R* value = Find(key))
+                return *value;
+            return Insert(key,compute(key));
+        }
+
+        /**
+         * Removes \c key, returns \c false if it was not cached.
+         */
+        bool Erase(const Key& key)
+        {
+            const std::uint32_t i = Locate(key,hash_(key));
+            if (i == npos)
+                return false;
+            EraseAt(i);
+            return true;
+        }
+
+        void Clear()
+        {
+            while (tail_ != npos)
+                EraseAt(tail_);
+        }
+
+    private:
+        std::uint32_t Locate(const Key& key, std::size_t hash) const
+        {
+            for (std::size_t i = hash & mask_; slots_[i].used;
+                i = (i + 1) & mask_)
+            {
+                if (slots_[i].hash == hash && slots_[i].key == key)
+                    return static_cast<std::uint32_t>(i);
+            }
+            return npos;
+        }
+
+        void EraseAt(std::uint32_t i)
+        {
+            Unlink(i);
+            slots_[i] = Slot{};
+            --size_;
+
+            // shift back every entry that probed past the hole
+            for (std::uint32_t j = Next(i); slots_[j].used; j = Next(j))
+            {
+                const std::size_t home = slots_[j].hash & mask_;
+                const bool between = i <= j
+                    ? (i < home && home <= j)
+                    : (i < home || home <= j);
+                if (between)
+                    continue;
+                slots_[i] = std::move(slots_[j]);
+                Relink(i);
+                slots_[j] = Slot{};
+                i = j;
+            }
+        }
+
+        std::uint32_t Next(std::uint32_t i) const
+        { return static_cast<std::uint32_t>((i + 1) & mask_); }
+
+        void Touch(std::uint32_t i)
+        {
+            if (head_ == i)
+                return;
+            Unlink(i);
+            PushFront(i);
+        }
+
+        void PushFront(std::uint32_t i)
+        {
+            slots_[i].prev = npos;
+            slots_[i].next = head_;
+            if (head_ != npos)
+                slots_[head_].prev = i;
+            else
+                tail_ = i;
+            head_ = i;
+        }
+
+        void Unlink(std::uint32_t i)
+        {
+            Slot& slot = slots_[i];
+            if (slot.prev != npos)
+                slots_[slot.prev].next = slot.next;
+            else
+                head_ = slot.next;
+            if (slot.next != npos)
+                slots_[slot.next].prev = slot.prev;
+            else
+                tail_ = slot.prev;
+        }
+
+        // points the neighbours of a moved entry at its new slot
+        void Relink(std::uint32_t i)
+        {
+            Slot& slot = slots_[i];
+            if (slot.prev != npos)
+                slots_[slot.prev].next = i;
+            else
+                head_ = i;
+            if (slot.next != npos)
+                slots_[slot.next].prev = i;
+            else
+                tail_ = i;
+        }
+};
+template <typename TList, typename R, typename HashFn>
+const std::uint32_t MemoCache<TList,R,HashFn>::npos;
+// }}} class MemoCache
+
+} // namespace: dea
+
+#endif
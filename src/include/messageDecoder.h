@@ -0,0 +1,327 @@
+/* {{{ LICENSE
+ * messageDecoder.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_MESSAGEDECODER_H
+#define DEA_MESSAGEDECODER_H
+
+// {{{ Includes
+#include "nullType.h"
+#include "typelist.h"
+#include "typemap.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ namespace: TL
+namespace TL
+{
+    // {{{ struct MaxSizeOf
+    /*! \struct dea::TL::MaxSizeOf
+     * The largest \c sizeof of the types in a dea::Typelist.
+     * You can access it by \c dea::TL::MaxSizeOf<TList>::value
+     *
+     * \tparam TList dea::Typelist to search through
+     */
+    template <typename TList> struct MaxSizeOf;
+    template <>
+    struct MaxSizeOf<NullType>
+    {
+        enum { value = 0 };
+    };
+    template <typename Head, typename Tail>
+    struct MaxSizeOf<Typelist<Head,Tail>>
+    {
+        private:
+            static const std::size_t rest = MaxSizeOf<Tail>::value;
+        public:
+            enum { value = sizeof(Head) > rest ? sizeof(Head) : rest };
+    };
+    // }}} struct MaxSizeOf
+}
+// }}} namespace: TL
+
+// {{{ class MessageView
+/*! \class dea::MessageView
+ * A view on the payload of a message inside a byte stream.
+ *
+ * Nothing is copied until \c Load is called, which copies the payload
+ * into a properly aligned \c M. The bytes stay valid as long as the
+ * buffer given to dea::MessageDecoder::Feed does, or until the next
+ * \c Feed for messages that were split across buffers.
+ *
+ * \tparam M Message type
+ */
+template <typename M>
+class MessageView
+{
+    static_assert(std::is_trivially_copyable<M>::value,
+        "MessageView needs a trivially copyable message type");
+
+    const char* data_;
+
+    public:
+        typedef M MessageType;
+
+        enum { size = sizeof(M) };
+
+        constexpr explicit MessageView(const char* data) : data_{data} {}
+
+        /**
+         * The raw payload bytes, possibly unaligned.
+         */
+        constexpr const char* Data() const { return data_; }
+
+        /**
+         * Copies the payload into an \c M.
+         */
+        M Load() const
+        {
+            M message;
+            std::memcpy(&message,data_,sizeof(M));
+            return message;
+        }
+};
+// }}} class MessageView
+
+// {{{ class MessageDecoder
+/*! \class dea::MessageDecoder
+ * Decodes a stream of tagged messages into dea::MessageView instances
+ * without allocating.
+ *
+ * Every message is a tag followed by the raw bytes of the message
+ * struct. The tag of a message type is its dea::TL::IndexOf in the
+ * dea::Typelist, stored little endian in a \c Tag; the payload keeps the
+ * writer's layout. \c Feed looks the tag up in a jump table generated
+ * from the typelist and calls the matching overload of the handler.
+ *
+ * A message split across two buffers is gathered in an internal buffer
+ * of the size of the largest message, all others are handed out in
+ * place.
+ *
+ * Example:
+ * \code
+ * typedef dea::MessageDecoder<typename dea::TL::MakeTypelist<
+ *      Login,Order,Cancel>::Result> Decoder;
+ *
+ * struct Handler
+ * {
+ *      void operator()(dea::MessageView<Login> login) { ... }
+ *      void operator()(dea::MessageView<Order> order)
+ *          { book.Add(order.Load()); }
+ *      void operator()(dea::MessageView<Cancel> cancel) { ... }
+ * };
+ *
+ * Decoder decoder;
+ * Handler handler;
+ * while ((n = ::read(fd,buffer,sizeof(buffer))) > 0)
+ *      decoder.Feed(buffer,n,handler);
+ * \endcode
+ *
+ * \tparam TList dea::Typelist of trivially copyable message types
+ * \tparam Tag Unsigned integer type of the tags
+ */
+template <typename TList, typename Tag = std::uint8_t>
+class MessageDecoder
+{
+    static_assert(std::is_unsigned<Tag>::value,
+        "MessageDecoder needs an unsigned tag type");
+
+    public:
+        enum
+        {
+            count = TL::Length<TList>::value,
+            tagSize = sizeof(Tag),
+            maxFrameSize = sizeof(Tag) + TL::MaxSizeOf<TList>::value
+        };
+
+    private:
+        static_assert(count > 0,"MessageDecoder needs message types");
+        static_assert(static_cast<unsigned long long>(count) - 1 <=
+            std::numeric_limits<Tag>::max(),
+            "MessageDecoder: too many message types for the tag type");
+
+        char carry_[maxFrameSize];
+        std::size_t carried_ = 0;
+
+    public:
+        MessageDecoder() = default;
+        MessageDecoder(const MessageDecoder&) = delete;
+        MessageDecoder& operator=(const MessageDecoder&) = delete;
+
+        /**
+         * The tag of message type \c M.
+         */
+        template <typename M>
+        static constexpr Tag TagOf()
+        {
+            static_assert(TL::IndexOf<TList,M>::value != -1,
+                "MessageDecoder: not a message type");
+            return static_cast<Tag>(TL::IndexOf<TList,M>::value);
+        }
+
+        /**
+         * Writes the frame of \c message to \c out, which has to hold
+         * \c sizeof(Tag) + \c sizeof(M) bytes. Returns the number of
+         * bytes written.
+         */
+        template <typename M>
+        static std::size_t Encode(const M& message, void* out)
+        {
+            char* p = static_cast<char*>(out);
+            const Tag tag = TagOf<M>();
+            for (std::size_t i = 0; i < sizeof(Tag); ++i)
+                p[i] = static_cast<char>(tag >> (8 * i) & 0xFF);
+            std::memcpy(p + sizeof(Tag),&message,sizeof(M));
+            return sizeof(Tag) + sizeof(M);
+        }
+
+        /**
+         * Decodes every complete message in the stream so far, calling
+         * \c handler with a dea::MessageView for each. An incomplete
+         * message at the end is kept for the next call.
+         * Returns the number of messages decoded.
+         *
+         * \throws std::runtime_error on an unknown tag, the decoder is
+         * reset then
+         */
+        template <typename Handler>
+        std::size_t Feed(const void* data, std::size_t size,
+            Handler& handler)
+        {
+            const char* p = static_cast<const char*>(data);
+            const char* const end = p + size;
+            std::size_t decoded = 0;
+
+            if (carried_ > 0)
+            {
+                if (carried_ < sizeof(Tag))
+                    p = Gather(p,end,sizeof(Tag));
+                if (carried_ < sizeof(Tag))
+                    return 0;
+                p = Gather(p,end,FrameSize(ReadTag(carry_)));
+                if (carried_ < FrameSize(ReadTag(carry_)))
+                    return 0;
+                carried_ = 0;
+                Dispatch(carry_,handler);
+                ++decoded;
+            }
+
+            while (static_cast<std::size_t>(end - p) >= sizeof(Tag))
+            {
+                const std::size_t frame = FrameSize(ReadTag(p));
+                if (static_cast<std::size_t>(end - p) < frame)
+                    break;
+                Dispatch(p,handler);
+                p += frame;
+                ++decoded;
+            }
+
+            carried_ = static_cast<std::size_t>(end - p);
+            std::memcpy(carry_,p,carried_);
+            return decoded;
+        }
+
+        /**
+         * Number of bytes of an incomplete message kept from the last
+         * \c Feed.
+         */
+        std::size_t Pending() const { return carried_; }
+
+        /**
+         * Drops an incomplete message, e.g. after a reconnect.
+         */
+        void Reset() { carried_ = 0; }
+
+    private:
+        template <typename Handler>
+        using Thunk = void (*)(const char*,Handler&);
+
+        template <typename Handler, typename M>
+        static void Call(const char* payload, Handler& handler)
+        { handler(MessageView<M>{payload}); }
+
+        template <typename Handler, unsigned int... i>
+        static Thunk<Handler> Lookup(Tag tag, IndexSequence<i...>)
+        {
+            static const Thunk<Handler> table[] =
+                { &Call<Handler,typename TL::TypeAt<TList,i>::Result>... };
+            return table[tag];
+        }
+
+        template <unsigned int... i>
+        static std::size_t SizeOf(Tag tag, IndexSequence<i...>)
+        {
+            static const std::size_t sizes[] =
+                { sizeof(typename TL::TypeAt<TList,i>::Result)... };
+            return sizes[tag];
+        }
+
+        template <typename Handler>
+        static void Dispatch(const char* frame, Handler& handler)
+        {
+            Lookup<Handler>(ReadTag(frame),
+                typename MakeIndexSequence<count>::Result{})(
+                    frame + sizeof(Tag),handler);
+        }
+
+        static Tag ReadTag(const char* p)
+        {
+            Tag tag = 0;
+            for (std::size_t i = 0; i < sizeof(Tag); ++i)
+                tag |= static_cast<Tag>(
+                    static_cast<Tag>(static_cast<unsigned char>(p[i])) << (8 * i));
+            return tag;
+        }
+
+        std::size_t FrameSize(Tag tag)
+        {
+            if (tag >= static_cast<unsigned long long>(count))
+            {
+                carried_ = 0;
+                throw std::runtime_error("MessageDecoder: unknown tag");
+            }
+            return sizeof(Tag) +
+                SizeOf(tag,typename MakeIndexSequence<count>::Result{});
+        }
+
+        // moves bytes into carry_ until it holds `want` of them
+        const char* Gather(const char* p, const char* end, std::size_t want)
+        {
+            std::size_t take = want - carried_;
+            if (take > static_cast<std::size_t>(end - p))
+                take = static_cast<std::size_t>(end - p);
+            std::memcpy(carry_ + carried_,p,take);
+            carried_ += take;
+            return p + take;
+        }
+};
+// }}} class MessageDecoder
+
+} // namespace: dea
+
+#endif
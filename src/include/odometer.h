@@ -0,0 +1,186 @@
+/* {{{ LICENSE
+ * odometer.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_ODOMETER_H
+#define DEA_ODOMETER_H
+
+// {{{ Includes
+#include "cycle.h"
+#include "nullType.h"
+#include "typelist.h"
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ class Odometer
+/*! \class dea::Odometer
+ * A mixed-radix counter whose digits are dea::StaticCycle types.
+ *
+ * The first type of the dea::Typelist is the least significant digit.
+ * Every increment steps it by its \c Step; when a digit wraps it
+ * carries into the next one. The carry chain is unrolled at compile
+ * time and needs one comparison per touched digit, no division.
+ *
+ * Example:
+ * \code
+ * typedef dea::Odometer<typename dea::TL::MakeTypelist<
+ *      dea::StaticCycle<int,0,59,1>,      // seconds
+ *      dea::StaticCycle<int,0,59,1>,      // minutes
+ *      dea::StaticCycle<int,0,23,1>>::Result> Clock;
+ *
+ * Clock clock{3725};                  // 01:02:05
+ * ++clock;
+ * int minutes = clock.Get<1>();
+ * \endcode
+ *
+ * \tparam TList dea::Typelist of dea::StaticCycle digit types
+ */
+template <typename TList> class Odometer;
+template <>
+class Odometer<NullType>
+{
+    public:
+        static constexpr unsigned long long cardinality = 1;
+
+        bool Increment() { return true; }
+        unsigned long long Advance(unsigned long long n) { return n; }
+        unsigned long long Index() const { return 0; }
+};
+template <typename Head, typename Tail>
+class Odometer<Typelist<Head,Tail>>
+{
+    typedef typename Head::ValueType T;
+    typedef CycleWrap<T,Head::minValue,Head::maxValue> Wrapper;
+
+    static_assert(Head::stepValue > 0 && Head::stepValue < Wrapper::Range,
+        "Odometer digits need 0 < Step < Max+1-Min");
+
+    Head digit_;
+    Odometer<Tail> rest_;
+
+    public:
+        typedef Typelist<Head,Tail> Digits;
+
+        enum { size = TL::Length<Digits>::value };
+
+        /**
+         * Number of distinct states, the product of all radices.
+         */
+        static constexpr unsigned long long cardinality =
+            static_cast<unsigned long long>(Wrapper::Range) *
+            Odometer<Tail>::cardinality;
+
+        /**
+         * Starts with every digit at its \c Min.
+         */
+        Odometer() : digit_{Head::minValue},rest_{} {}
+        /**
+         * Starts at the state after \c steps increments.
+         */
+        explicit Odometer(unsigned long long steps) : Odometer{}
+            { Advance(steps); }
+
+        /**
+         * Steps the least significant digit, carrying into the others.
+         * Returns \c true if the most significant digit wrapped.
+         */
+        bool Increment()
+        {
+            const T v = digit_();
+            if (v > Head::maxValue - Head::stepValue)
+            {
+                digit_ = static_cast<T>(v - (Wrapper::Range - Head::stepValue));
+                return rest_.Increment();
+            }
+            digit_ = static_cast<T>(v + Head::stepValue);
+            return false;
+        }
+
+        Odometer& operator++() { Increment(); return *this; }
+
+        /**
+         * Performs \c n increments at once, one division per digit.
+         * Returns how often the most significant digit wrapped.
+         */
+        unsigned long long Advance(unsigned long long n)
+        {
+            const unsigned long long range = Wrapper::Range;
+            const unsigned long long offset =
+                static_cast<unsigned long long>(digit_() - Head::minValue);
+            // offset + n * Step without overflowing, split into digit
+            // and carry
+            const unsigned long long step = Head::stepValue;
+            const unsigned long long t = offset + (n % range) * step;
+            digit_ = static_cast<T>(Head::minValue + static_cast<T>(t % range));
+            return rest_.Advance((n / range) * step + t / range);
+        }
+
+        /**
+         * The flat index of the current state, \c Step 1 digits count
+         * 0,1,2,... up to \c cardinality - 1.
+         */
+        unsigned long long Index() const
+        {
+            return static_cast<unsigned long long>(digit_() - Head::minValue)
+                + static_cast<unsigned long long>(Wrapper::Range) *
+                  rest_.Index();
+        }
+
+        /**
+         * Sets the digits to the decomposition of \c steps increments
+         * from the start.
+         */
+        void Set(unsigned long long steps)
+        {
+            *this = Odometer{};
+            Advance(steps);
+        }
+
+        /**
+         * Value of digit \c i, 0 being the least significant.
+         */
+        template <unsigned int i>
+        typename TL::TypeAt<Digits,i>::Result::ValueType Get() const
+        { return GetHelper<i>::Do(*this); }
+
+    private:
+        template <typename> friend class Odometer;
+
+        template <unsigned int i, typename Dummy = void>
+        struct GetHelper
+        {
+            static typename TL::TypeAt<Digits,i>::Result::ValueType
+            Do(const Odometer& o)
+            { return o.rest_.template Get<i-1>(); }
+        };
+        template <typename Dummy>
+        struct GetHelper<0,Dummy>
+        {
+            static T Do(const Odometer& o) { return o.digit_(); }
+        };
+};
+template <typename Head, typename Tail>
+constexpr unsigned long long Odometer<Typelist<Head,Tail>>::cardinality;
+// }}} class Odometer
+
+} // namespace: dea
+
+#endif
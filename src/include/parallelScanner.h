@@ -0,0 +1,337 @@
+/* {{{ LICENSE
+ * parallelScanner.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_PARALLELSCANNER_H
+#define DEA_PARALLELSCANNER_H
+
+// {{{ Includes
+#include "threadPool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ class ParallelScanner
+/*! \class dea::ParallelScanner
+ * Runs a dea::Dfa over a large input on all workers of a
+ * dea::ThreadPool, with the same results as a sequential scan.
+ *
+ * The input is split into chunks that are scanned at the same time.
+ * Only the first chunk knows the state it starts in; for the others
+ * the scanner guesses:
+ *  - Every state is run over the last \c lookback bytes before the
+ *    chunk. The automaton must be in one of the states this leads to,
+ *    and for most automata that is a single state after a few bytes.
+ *  - If several candidates are left, they are run through the chunk in
+ *    lockstep, merging the ones that meet, until one is left. The chunk
+ *    then maps each candidate to the state it ends in.
+ * Composing these maps from the first chunk on gives the real start
+ * state of every chunk. Chunks whose start state was known beforehand
+ * keep the matches they found; the others are scanned a second time.
+ *
+ * Example:
+ * \code
+ * dea::ThreadPool pool;
+ * dea::MappedFile log("/var/log/huge.log");
+ * dea::ParallelScanner<ErrorDfa> scanner(pool);
+ *
+ * std::size_t errors =
+ *      scanner.Count(ErrorDfa::Start(),log.begin(),log.end());
+ * \endcode
+ *
+ * \tparam Automaton dea::Dfa to run
+ */
+template <typename Automaton>
+class ParallelScanner
+{
+    public:
+        typedef typename Automaton::StateId StateId;
+
+    private:
+        // what a chunk keeps of its matches
+        struct Ignore
+        {
+            enum { matches = false };
+            StateId Feed(StateId state, const char* begin, const char* end)
+            { return Automaton::Run(state,begin,end); }
+            void Clear() {}
+        };
+        struct Counter
+        {
+            enum { matches = true };
+            std::size_t count = 0;
+            StateId Feed(StateId state, const char* begin, const char* end)
+            { return Automaton::Scan(state,begin,end,*this); }
+            void operator()(const char*) { ++count; }
+            void Clear() { count = 0; }
+        };
+        struct Positions
+        {
+            enum { matches = true };
+            std::vector<const char*> positions;
+            StateId Feed(StateId state, const char* begin, const char* end)
+            { return Automaton::Scan(state,begin,end,*this); }
+            void operator()(const char* position)
+            { positions.push_back(position); }
+            void Clear() { positions.clear(); }
+        };
+
+        template <typename Collect>
+        struct Chunk
+        {
+            const char* begin;
+            const char* end;
+            std::vector<StateId> from;  // candidate start states
+            std::vector<StateId> to;    // the state each one ends in
+            bool known;                 // collect holds the matches of from[0]
+            Collect collect;
+        };
+
+        ThreadPool& pool_;
+        std::size_t chunkSize_;
+        std::size_t lookback_;
+
+    public:
+        /**
+         * \param chunkSize Bytes per task
+         * \param lookback Bytes before a chunk used to narrow down its
+         *      start state
+         * \throws std::invalid_argument if \c chunkSize is zero
+         */
+        explicit ParallelScanner(ThreadPool& pool,
+            std::size_t chunkSize = std::size_t(1) << 22,
+            std::size_t lookback = 256)
+            : pool_(pool), chunkSize_(chunkSize), lookback_(lookback)
+        {
+            if (chunkSize == 0)
+                throw std::invalid_argument(
+                    "ParallelScanner: chunk size must not be zero");
+        }
+
+        /**
+         * Same as \c Automaton::Run(state,begin,end).
+         */
+        StateId Run(StateId state, const char* begin, const char* end)
+        {
+            std::vector<Chunk<Ignore>> chunks;
+            return Go(state,begin,end,chunks);
+        }
+
+        /**
+         * Number of positions \c Automaton::Scan(state,begin,end,...)
+         * reports.
+         */
+        std::size_t Count(StateId state, const char* begin, const char* end)
+        {
+            std::vector<Chunk<Counter>> chunks;
+            Go(state,begin,end,chunks);
+            std::size_t count = 0;
+            for (const Chunk<Counter>& chunk : chunks)
+                count += chunk.collect.count;
+            return count;
+        }
+
+        /**
+         * Same as \c Automaton::Scan(state,begin,end,match). The matches
+         * are buffered and \c match is called on the calling thread, in
+         * order, once the whole input is scanned.
+         */
+        template <typename F>
+        StateId Scan(StateId state, const char* begin, const char* end,
+            F&& match)
+        {
+            std::vector<Chunk<Positions>> chunks;
+            const StateId last = Go(state,begin,end,chunks);
+            for (const Chunk<Positions>& chunk : chunks)
+                for (const char* position : chunk.collect.positions)
+                    match(position);
+            return last;
+        }
+
+    private:
+        // Leaves the chunks the automaton got to in `chunks`.
+        template <typename Collect>
+        StateId Go(StateId state, const char* begin, const char* end,
+            std::vector<Chunk<Collect>>& chunks)
+        {
+            const std::size_t size = static_cast<std::size_t>(end - begin);
+            const std::size_t n =
+                size <= chunkSize_ ? 1 : (size - 1) / chunkSize_ + 1;
+            chunks.resize(n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                chunks[i].begin = begin + i * chunkSize_;
+                chunks[i].end =
+                    i + 1 == n ? end : chunks[i].begin + chunkSize_;
+            }
+            if (n == 1)
+                return chunks[0].collect.Feed(state,begin,end);
+
+            {
+                TaskGroup group(pool_);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    Chunk<Collect>& chunk = chunks[i];
+                    group.Run([this,&chunk,i,state,begin]
+                        { Speculate(chunk,i == 0,state,begin); });
+                }
+                group.Wait();
+            }
+
+            std::vector<std::size_t> again;
+            std::vector<StateId> starts(n);
+            std::size_t reached = 0;
+            for (; reached < n && !Automaton::IsDead(state); ++reached)
+            {
+                Chunk<Collect>& chunk = chunks[reached];
+                starts[reached] = state;
+                const std::size_t k = static_cast<std::size_t>(
+                    std::find(chunk.from.begin(),chunk.from.end(),state) -
+                    chunk.from.begin());
+                if (k == chunk.from.size())
+                {
+                    // cannot happen, but costs nothing to get right
+                    chunk.collect.Clear();
+                    state = chunk.collect.Feed(state,chunk.begin,chunk.end);
+                    continue;
+                }
+                if (Collect::matches && !(chunk.known && k == 0))
+                    again.push_back(reached);
+                state = chunk.to[k];
+            }
+            chunks.resize(reached);
+
+            if (!again.empty())
+            {
+                TaskGroup group(pool_);
+                for (std::size_t i : again)
+                {
+                    Chunk<Collect>& chunk = chunks[i];
+                    const StateId start = starts[i];
+                    group.Run([&chunk,start]
+                    {
+                        chunk.collect.Clear();
+                        chunk.collect.Feed(start,chunk.begin,chunk.end);
+                    });
+                }
+                group.Wait();
+            }
+            return state;
+        }
+
+        template <typename Collect>
+        void Speculate(Chunk<Collect>& chunk, bool first, StateId state,
+            const char* begin) const
+        {
+            std::vector<StateId>& from = chunk.from;
+            if (first)
+                from.assign(1,state);
+            else
+            {
+                const std::size_t back = std::min(lookback_,
+                    static_cast<std::size_t>(chunk.begin - begin));
+                Candidates(from,chunk.begin - back,chunk.begin);
+            }
+
+            chunk.to.resize(from.size());
+            chunk.known = from.size() == 1;
+            if (chunk.known)
+                chunk.to[0] =
+                    chunk.collect.Feed(from[0],chunk.begin,chunk.end);
+            else if (!from.empty())
+                Converge(from,chunk.to,chunk.begin,chunk.end);
+        }
+
+        // the live states the automaton can be in after [u,end)
+        static void Candidates(std::vector<StateId>& from,
+            const char* u, const char* end)
+        {
+            from.clear();
+            for (unsigned int i = 0; i < Automaton::states; ++i)
+                from.push_back(Automaton::State(i));
+            while (from.size() > 1 && u != end)
+            {
+                const unsigned char byte = static_cast<unsigned char>(*u++);
+                for (StateId& state : from)
+                    state = Automaton::Next(state,byte);
+                std::sort(from.begin(),from.end());
+                from.erase(std::unique(from.begin(),from.end()),from.end());
+                if (Automaton::IsDead(from.front()))
+                    from.erase(from.begin());
+            }
+            if (from.size() == 1)
+            {
+                from[0] = Automaton::Run(from[0],u,end);
+                if (Automaton::IsDead(from[0]))
+                    from.clear();
+            }
+        }
+
+        // runs all of `from` through [u,end) at once
+        static void Converge(const std::vector<StateId>& from,
+            std::vector<StateId>& to, const char* u, const char* end)
+        {
+            std::vector<StateId> current(from);
+            std::vector<std::size_t> owner(from.size());
+            for (std::size_t k = 0; k < owner.size(); ++k)
+                owner[k] = k;
+            std::vector<int> slot(Automaton::states + 1,-1);
+            std::vector<std::size_t> merged(from.size());
+            while (current.size() > 1 && u != end)
+            {
+                const unsigned char byte = static_cast<unsigned char>(*u++);
+                std::size_t kept = 0;
+                for (std::size_t j = 0; j < current.size(); ++j)
+                {
+                    const StateId next = Automaton::Next(current[j],byte);
+                    int& s = slot[Automaton::Index(next) + 1];
+                    if (s < 0)
+                    {
+                        s = static_cast<int>(kept);
+                        current[kept++] = next;
+                    }
+                    merged[j] = static_cast<std::size_t>(s);
+                }
+                for (std::size_t j = 0; j < kept; ++j)
+                    slot[Automaton::Index(current[j]) + 1] = -1;
+                if (kept < current.size())
+                {
+                    for (std::size_t& k : owner)
+                        k = merged[k];
+                    current.resize(kept);
+                }
+            }
+            if (current.size() == 1)
+                current[0] = Automaton::Run(current[0],u,end);
+            for (std::size_t k = 0; k < owner.size(); ++k)
+                to[k] = current[owner[k]];
+        }
+};
+// }}} class ParallelScanner
+
+} // namespace: dea
+
+#endif
@@ -0,0 +1,232 @@
+/* {{{ LICENSE
+ * phaseCycle.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_PHASECYCLE_H
+#define DEA_PHASECYCLE_H
+
+// {{{ Includes
+#include "cycle.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ Overload policies
+/*! \class dea::PhaseStdOverload
+ * Lets a dea::PhaseCycle wrap silently. The unsigned phase wraps on
+ * overflow by itself, so there is nothing to do.
+ */
+template <typename T>
+class PhaseStdOverload
+{
+    protected:
+        ~PhaseStdOverload() noexcept = default;
+
+        static DEA_CXX14_CONSTEXPR void Overload(T,T,bool,long int) {}
+};
+
+/*! \class dea::PhaseCountOverload
+ * Counts the turns of a dea::PhaseCycle, positive when stepping
+ * forwards over 1.0 and negative when stepping backwards under 0.0.
+ * Whole turns added by operator+= and operator-= are counted as well.
+ */
+template <typename T>
+class PhaseCountOverload
+{
+    std::shared_ptr<long int> counter_ = {nullptr};
+
+    public:
+        virtual ~PhaseCountOverload() noexcept = default;
+        void setCounter(const std::shared_ptr<long int>& counter)
+            { counter_ = counter; }
+
+    protected:
+        void Overload(T before,T after,bool forwards,long int whole)
+        {
+            if (!counter_) return;
+            *counter_ += whole;
+            if (forwards && after < before) ++(*counter_);
+            if (!forwards && after > before) --(*counter_);
+        };
+};
+// }}} Overload policies
+
+// {{{ class PhaseCycle
+/*! \class dea::PhaseCycle
+ * A fixed-point phase accumulator cycling through [0.0,1.0).
+ *
+ * The phase is stored as a full-width unsigned integer in which 1.0
+ * equals 2^bits, so wrapping is the free unsigned overflow and steps
+ * can be arbitrary fractions of a turn. The step is set at runtime.
+ *
+ * Example:
+ * \code
+ * dea::PhaseCycle<std::uint32_t> phase;
+ * phase.setStep(440.0 / 48000.0);
+ *
+ * for (auto& sample : block)
+ *     sample = table[(phase++).Index<10>()];
+ * \endcode
+ *
+ * \tparam T Unsigned integer type holding the phase
+ * \tparam OnOverload Overload policy, see dea::PhaseStdOverload
+ */
+template <typename T = std::uint32_t,
+    template <typename> class OnOverload=PhaseStdOverload>
+class PhaseCycle final : public OnOverload<T>
+{
+    static_assert(std::is_unsigned<T>::value,
+        "PhaseCycle needs an unsigned phase type");
+
+    typedef OnOverload<T> Base;
+
+    T value_;
+    T step_;
+
+    public:
+        typedef T ValueType;
+
+        enum { bits = std::numeric_limits<T>::digits };
+
+        constexpr PhaseCycle() : Base{},value_{0},step_{0} {}
+        /**
+         * \param phase Initial phase in turns
+         * \param step Step in turns
+         */
+        constexpr PhaseCycle(double phase, double step = 0.0)
+            : Base{},value_{FromTurns(phase)},step_{FromTurns(step)} {}
+        constexpr PhaseCycle(const PhaseCycle& other)
+            : Base{},value_{other.value_},step_{other.step_} {}
+        DEA_CXX14_CONSTEXPR PhaseCycle& operator=(const PhaseCycle& rhs)
+            { value_ = rhs.value_; step_ = rhs.step_; return *this; }
+        ~PhaseCycle() noexcept = default;
+
+        /**
+         * The raw fixed-point phase.
+         */
+        constexpr const T operator()() const { return value_; }
+        constexpr T step() const { return step_; }
+
+        DEA_CXX14_CONSTEXPR void setStep(double turns)
+            { step_ = FromTurns(turns); }
+        DEA_CXX14_CONSTEXPR void setRawStep(T step) { step_ = step; }
+        DEA_CXX14_CONSTEXPR void setRaw(T value) { value_ = value; }
+
+        /**
+         * Index into a table of 2^indexBits entries, taken from the
+         * upper bits of the phase.
+         */
+        template <unsigned int indexBits>
+        constexpr T Index() const
+        {
+            static_assert(indexBits > 0 && indexBits <= bits,
+                "PhaseCycle::Index needs 0 < indexBits <= bits");
+            return value_ >> (bits - indexBits);
+        }
+
+        /**
+         * The phase as a float in [0,1).
+         */
+        constexpr float Float() const
+        {
+            return static_cast<float>(value_ >> Shift) *
+                static_cast<float>(1.0 / TwoPow(bits - Shift));
+        }
+
+        /**
+         * The phase as a double in [0,1).
+         */
+        constexpr double Double() const
+        { return static_cast<double>(value_) * (1.0 / TwoPow(bits)); }
+
+        DEA_CXX14_CONSTEXPR PhaseCycle& operator++()
+        { return Add(step_,true,0); }
+        DEA_CXX14_CONSTEXPR PhaseCycle& operator--()
+        { return Add(T(0)-step_,false,0); }
+        DEA_CXX14_CONSTEXPR PhaseCycle operator++(int)
+        { PhaseCycle tmp{*this}; Add(step_,true,0); return tmp; }
+        DEA_CXX14_CONSTEXPR PhaseCycle operator--(int)
+        { PhaseCycle tmp{*this}; Add(T(0)-step_,false,0); return tmp; }
+        /**
+         * Adds \c turns turns. Only the fractional part moves the phase,
+         * the whole part is passed on to the overload policy.
+         */
+        DEA_CXX14_CONSTEXPR PhaseCycle& operator+=(double turns)
+        {
+            return Add(FromTurns(turns),true,
+                static_cast<long int>(Floor(turns)));
+        }
+        DEA_CXX14_CONSTEXPR PhaseCycle& operator-=(double turns)
+        { return *this += -turns; }
+
+        /**
+         * Converts turns into the fixed-point representation, keeping
+         * only the fractional part.
+         */
+        static constexpr T FromTurns(double turns)
+        { return Fixed(turns - Floor(turns)); }
+
+        /**
+         * Does NOT swap OnOverload members
+         */
+        inline friend void swap(PhaseCycle& lhs,PhaseCycle& rhs) noexcept
+        {
+            std::swap(lhs.value_,rhs.value_);
+            std::swap(lhs.step_,rhs.step_);
+        }
+
+    private:
+        // float holds 24 bits of mantissa, drop the rest before the
+        // conversion so it stays a plain integer-to-float
+        enum { Shift = bits > 24 ? bits - 24 : 0 };
+        static constexpr double TwoPow(unsigned int n)
+        { return n == 0 ? 1.0 : 2.0 * TwoPow(n - 1); }
+        // a fraction just below 0 rounds up to 1.0 in turns - Floor(turns)
+        static constexpr T Fixed(double fraction)
+        {
+            return fraction >= 1.0 ? T(0) : static_cast<T>(
+                static_cast<std::uint64_t>(fraction * TwoPow(bits)));
+        }
+        static constexpr double Floor(double x)
+        {
+            return static_cast<double>(static_cast<std::int64_t>(x)) > x
+                ? static_cast<double>(static_cast<std::int64_t>(x)) - 1.0
+                : static_cast<double>(static_cast<std::int64_t>(x));
+        }
+
+        DEA_CXX14_CONSTEXPR PhaseCycle& Add(T delta,bool forwards,
+            long int whole)
+        {
+            const T before = value_;
+            value_ += delta;
+            Base::Overload(before,value_,forwards,whole);
+            return *this;
+        }
+};
+// }}} class PhaseCycle
+
+} // namespace: dea
+
+#endif
@@ -0,0 +1,379 @@
+/* {{{ LICENSE
+ * pipeline.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_PIPELINE_H
+#define DEA_PIPELINE_H
+
+// {{{ Includes
+#include "hierarchy.h"
+#include "ring.h"
+#include "typelist.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ struct PipelineRoot
+/*! \struct dea::PipelineRoot
+ * The end of a dea::Pipeline, passes the output of the last stage to
+ * the sink.
+ *
+ * \tparam Sink Functor taking the output of the last stage
+ */
+template <typename Sink>
+class PipelineRoot
+{
+    Sink sink_;
+
+    public:
+        Sink& sink() { return sink_; }
+
+        template <typename T>
+        void Push(T&& item) { sink_(std::forward<T>(item)); }
+        template <typename T>
+        void Enqueue(T&& item) { sink_(std::forward<T>(item)); }
+        void Notify() {}
+        void Close() {}
+};
+// }}} struct PipelineRoot
+
+// {{{ struct PipelineStageAt
+template <unsigned int i>
+struct PipelineStageAt
+{
+    template <typename U>
+    static auto Get(U& unit)
+        -> decltype(PipelineStageAt<i-1>::Get(
+            std::declval<typename U::Next&>()))
+    { return PipelineStageAt<i-1>::Get(
+        static_cast<typename U::Next&>(unit)); }
+};
+template <>
+struct PipelineStageAt<0>
+{
+    template <typename U>
+    static auto Get(U& unit) -> decltype(unit.stage())
+    { return unit.stage(); }
+};
+// }}} struct PipelineStageAt
+
+// {{{ struct InlinePipeline
+/*! \struct dea::InlinePipeline
+ * Mode of a dea::Pipeline that runs every stage on the pushing thread.
+ * Each stage calls the next one directly, so the whole chain inlines
+ * into one call.
+ */
+struct InlinePipeline
+{
+    template <typename S, typename Base>
+    class Unit : public Base
+    {
+        struct Emit
+        {
+            Base& next;
+            template <typename T>
+            void operator()(T&& item) const
+            { next.Push(std::forward<T>(item)); }
+        };
+
+        S stage_;
+
+        public:
+            typedef typename S::Input Input;
+            typedef Base Next;
+
+            S& stage() { return stage_; }
+
+            template <typename T>
+            void Push(T&& item)
+            {
+                // stages take an Input&& in both modes
+                const Emit emit{*this};
+                stage_(Input(std::forward<T>(item)),emit);
+            }
+    };
+};
+// }}} struct InlinePipeline
+
+// {{{ struct ThreadedPipeline
+/*! \struct dea::ThreadedPipeline
+ * Mode of a dea::Pipeline that runs every stage on its own thread.
+ *
+ * Stages are connected by dea::SpscRing queues of \c capacity items.
+ * A stage thread takes up to \c batch items out of its queue at once;
+ * the pushing thread (and every stage) waits with
+ * \c std::this_thread::yield while the next queue is full.
+ *
+ * A stage whose queue is empty yields \c idleSpins times, then sleeps on
+ * a condition variable until an item is pushed or the pipeline is
+ * closed, so idle stages do not hold on to a core. Checking for a
+ * sleeping stage costs a fence, which \c Push pays per item and a stage
+ * thread once per batch; waking the stage costs a lock.
+ *
+ * \c Close drains the stages in order and joins their threads. The
+ * first exception thrown by a stage is rethrown by \c Close; the
+ * stage's remaining input is dropped.
+ *
+ * \tparam capacity Queue size between two stages
+ * \tparam batch Maximum number of items a stage takes at once
+ * \tparam idleSpins Empty polls before a stage goes to sleep
+ */
+template <std::size_t capacity = 1024, std::size_t batch = 64,
+    std::size_t idleSpins = 64>
+struct ThreadedPipeline
+{
+    static_assert(batch > 0,"ThreadedPipeline needs a batch size");
+
+    template <typename S, typename Base>
+    class Unit : public Base
+    {
+        struct Emit
+        {
+            Base& next;
+            template <typename T>
+            void operator()(T&& item) const
+            { next.Enqueue(std::forward<T>(item)); }
+        };
+
+        public:
+            typedef typename S::Input Input;
+            typedef Base Next;
+
+        private:
+            S stage_;
+            SpscRing<Input,capacity> ring_;
+            std::atomic<bool> closed_ = {false};
+            std::atomic<bool> sleeping_ = {false};
+            std::mutex wakeMutex_;
+            std::condition_variable wake_;
+            std::exception_ptr error_;
+            std::thread thread_;
+
+        public:
+            Unit() : thread_{&Unit::Run,this} {}
+            Unit(const Unit&) = delete;
+            Unit& operator=(const Unit&) = delete;
+            ~Unit()
+            {
+                try { Close(); } catch (...) {}
+            }
+
+            template <typename T>
+            void Push(T&& item)
+            {
+                Enqueue(std::forward<T>(item));
+                Notify();
+            }
+
+            /**
+             * Like \c Push, but the stage may sleep through the item
+             * until the next \c Notify.
+             */
+            template <typename T>
+            void Enqueue(T&& item)
+            {
+                while (!ring_.Push(std::forward<T>(item)))
+                {
+                    Notify();
+                    std::this_thread::yield();
+                }
+            }
+
+            /**
+             * Wakes the stage if it sleeps.
+             */
+            void Notify()
+            {
+                // pairs with the fence in Sleep: either the stage sees
+                // the items, or this sees the stage sleeping
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                // only the first notify after the stage fell asleep
+                // wakes it
+                if (sleeping_.load(std::memory_order_relaxed) &&
+                    sleeping_.exchange(false,std::memory_order_relaxed))
+                    Wake();
+            }
+
+            S& stage() { return stage_; }
+
+            void Close()
+            {
+                if (!thread_.joinable())
+                    return;
+                closed_.store(true,std::memory_order_release);
+                Wake();
+                thread_.join();
+                if (error_)
+                {
+                    std::exception_ptr error = error_;
+                    error_ = nullptr;
+                    std::rethrow_exception(error);
+                }
+            }
+
+        private:
+            void Run()
+            {
+                std::vector<Input> items(batch);
+                const Emit emit{*this};
+                std::size_t idle = 0;
+                for (;;)
+                {
+                    // everything pushed before Close is visible now
+                    const bool closed =
+                        closed_.load(std::memory_order_acquire);
+                    const std::size_t n = ring_.PopN(items.data(),batch);
+                    if (n == 0)
+                    {
+                        if (closed)
+                            break;
+                        if (++idle < idleSpins)
+                            std::this_thread::yield();
+                        else
+                        {
+                            Sleep();
+                            idle = 0;
+                        }
+                        continue;
+                    }
+                    idle = 0;
+                    if (error_)
+                        continue;
+                    try
+                    {
+                        for (std::size_t i = 0; i < n; ++i)
+                            stage_(std::move(items[i]),emit);
+                    }
+                    catch (...)
+                    {
+                        error_ = std::current_exception();
+                    }
+                    Base::Notify();
+                }
+                try
+                {
+                    Base::Close();
+                }
+                catch (...)
+                {
+                    if (!error_)
+                        error_ = std::current_exception();
+                }
+            }
+
+            void Sleep()
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex_);
+                for (;;)
+                {
+                    // set again after every wake: a Notify that saw an
+                    // earlier sleep may clear the flag of this one
+                    sleeping_.store(true,std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (closed_.load(std::memory_order_acquire) ||
+                        ring_.Size() != 0)
+                        break;
+                    wake_.wait(lock);
+                }
+                sleeping_.store(false,std::memory_order_relaxed);
+            }
+
+            void Wake()
+            {
+                // a stage between its check and the wait holds the mutex
+                std::lock_guard<std::mutex> lock(wakeMutex_);
+                wake_.notify_one();
+            }
+    };
+};
+// }}} struct ThreadedPipeline
+
+// {{{ class Pipeline
+/*! \class dea::Pipeline
+ * A chain of processing stages generated with dea::GenLinearHiearchy.
+ *
+ * A stage names its \c Input type and is called with an input item and
+ * an emitter. It passes any number of items on to the next stage by
+ * calling the emitter, so stages can transform, filter and split:
+ * \code
+ * struct Validate
+ * {
+ *     typedef Record Input;
+ *     template <typename Emit>
+ *     void operator()(Record&& record, const Emit& emit)
+ *     {
+ *         if (record.Valid())
+ *             emit(std::move(record));
+ *     }
+ * };
+ *
+ * typedef typename dea::TL::MakeTypelist<Parse,Validate,Enrich>::Result
+ *      Stages;
+ *
+ * dea::Pipeline<Stages,Emitter> inlined;
+ * dea::Pipeline<Stages,Emitter,dea::ThreadedPipeline<>> threaded;
+ *
+ * for (auto& line : lines)
+ *     threaded.Push(line);
+ * threaded.Close();
+ * \endcode
+ *
+ * The same stages run in both modes, see dea::InlinePipeline and
+ * dea::ThreadedPipeline. In threaded mode the stages and the sink run
+ * on the stage threads, so only inspect them after \c Close.
+ *
+ * \tparam Stages dea::Typelist of stage types, at least one
+ * \tparam Sink Functor taking the output of the last stage
+ * \tparam Mode dea::InlinePipeline or dea::ThreadedPipeline
+ */
+template <typename Stages, typename Sink, typename Mode = InlinePipeline>
+class Pipeline
+    : public GenLinearHiearchy<Stages,Mode::template Unit,PipelineRoot<Sink>>
+{
+    static_assert(TL::Length<Stages>::value > 0,
+        "Pipeline needs at least one stage");
+
+    public:
+        typedef typename TL::TypeAt<Stages,0>::Result::Input Input;
+
+        /**
+         * The stage at index \c i.
+         */
+        template <unsigned int i>
+        typename TL::TypeAt<Stages,i>::Result& Stage()
+        { return PipelineStageAt<i>::Get(*this); }
+
+        Sink& sink()
+        { return static_cast<PipelineRoot<Sink>&>(*this).sink(); }
+};
+// }}} class Pipeline
+
+} // namespace: dea
+
+#endif
@@ -0,0 +1,375 @@
+/* {{{ LICENSE
+ * ring.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_RING_H
+#define DEA_RING_H
+
+// {{{ Includes
+#include "cacheLine.h"
+#include "cycle.h"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ class SpscRing
+/*! \class dea::SpscRing
+ * A lock-free ring buffer for exactly one producer and one consumer
+ * thread.
+ *
+ * Head and tail are dea::StaticCycle positions in [0,2N), so a full and
+ * an empty ring can be told apart without wasting a slot. If \c N is a
+ * power of two every index computation is a mask.
+ *
+ * Head and tail live on their own cache lines, each side caches the
+ * other side's position and only reloads it when the ring looks full or
+ * empty. \c PushN and \c PopN move many elements with one atomic store.
+ *
+ * Example:
+ * \code
+ * dea::SpscRing<Message,1024> ring;
+ *
+ * // producer
+ * while (!ring.Push(msg)) {}
+ *
+ * // consumer
+ * Message batch[64];
+ * std::size_t n = ring.PopN(batch,64);
+ * \endcode
+ *
+ * \tparam T Element type
+ * \tparam N Capacity
+ */
+template <typename T, std::size_t N>
+class SpscRing
+{
+    static_assert(N > 0,"SpscRing needs a capacity");
+
+    typedef StaticCycle<std::size_t,0,2*N-1,1> Position;
+    typedef typename std::aligned_storage<sizeof(T),alignof(T)>::type Slot;
+
+    // consumer side
+    alignas(DEA_CACHE_LINE_SIZE) std::atomic<std::size_t> head_ = {0};
+    std::size_t cachedTail_ = 0;
+    // producer side
+    alignas(DEA_CACHE_LINE_SIZE) std::atomic<std::size_t> tail_ = {0};
+    std::size_t cachedHead_ = 0;
+
+    alignas(DEA_CACHE_LINE_SIZE) Slot slots_[N];
+
+    public:
+        typedef T ValueType;
+        enum { capacity = N };
+
+        SpscRing() = default;
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+        ~SpscRing()
+        {
+            const std::size_t tail = tail_.load(std::memory_order_acquire);
+            for (std::size_t head = head_.load(std::memory_order_relaxed);
+                head != tail; head = (++Position{head})())
+                reinterpret_cast<T*>(&slots_[SlotOf(head)])->~T();
+        }
+
+        /**
+         * Producer: appends \c item, returns \c false if the ring is full.
+         */
+        template <typename U>
+        bool Push(U&& item)
+        {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            if (Distance(tail,cachedHead_) == N)
+            {
+                cachedHead_ = head_.load(std::memory_order_acquire);
+                if (Distance(tail,cachedHead_) == N)
+                    return false;
+            }
+            new (&slots_[SlotOf(tail)]) T(std::forward<U>(item));
+            tail_.store((++Position{tail})(),std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Producer: appends up to \c n items, returns how many were
+         * appended.
+         */
+        std::size_t PushN(const T* items, std::size_t n)
+        {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            std::size_t space = N - Distance(tail,cachedHead_);
+            if (space < n)
+            {
+                cachedHead_ = head_.load(std::memory_order_acquire);
+                space = N - Distance(tail,cachedHead_);
+            }
+            const std::size_t count = n < space ? n : space;
+            std::size_t slot = SlotOf(tail);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                new (&slots_[slot]) T(items[i]);
+                slot = NextSlot(slot);
+            }
+            Position next{tail};
+            next += count;
+            tail_.store(next(),std::memory_order_release);
+            return count;
+        }
+
+        /**
+         * Consumer: removes the oldest item into \c item, returns
+         * \c false if the ring is empty.
+         */
+        bool Pop(T& item)
+        {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            if (head == cachedTail_)
+            {
+                cachedTail_ = tail_.load(std::memory_order_acquire);
+                if (head == cachedTail_)
+                    return false;
+            }
+            T* slot = reinterpret_cast<T*>(&slots_[SlotOf(head)]);
+            item = std::move(*slot);
+            slot->~T();
+            head_.store((++Position{head})(),std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Consumer: removes up to \c n items into \c items, returns how
+         * many were removed.
+         */
+        std::size_t PopN(T* items, std::size_t n)
+        {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            std::size_t available = Distance(cachedTail_,head);
+            if (available < n)
+            {
+                cachedTail_ = tail_.load(std::memory_order_acquire);
+                available = Distance(cachedTail_,head);
+            }
+            const std::size_t count = n < available ? n : available;
+            std::size_t slot = SlotOf(head);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                T* p = reinterpret_cast<T*>(&slots_[slot]);
+                items[i] = std::move(*p);
+                p->~T();
+                slot = NextSlot(slot);
+            }
+            Position next{head};
+            next += count;
+            head_.store(next(),std::memory_order_release);
+            return count;
+        }
+
+        /**
+         * Number of items, only exact if neither side is active.
+         */
+        std::size_t Size() const
+        {
+            return Distance(tail_.load(std::memory_order_acquire),
+                            head_.load(std::memory_order_acquire));
+        }
+
+    private:
+        // positions are in [0,2N), so both need one subtraction at most
+        static std::size_t Distance(std::size_t to, std::size_t from)
+        { return Position{to + 2*N - from}(); }
+        static std::size_t SlotOf(std::size_t position)
+        { return position >= N ? position - N : position; }
+        static std::size_t NextSlot(std::size_t slot)
+        { return slot + 1 == N ? 0 : slot + 1; }
+};
+// }}} class SpscRing
+
+// {{{ class MpmcRing
+/*! \class dea::MpmcRing
+ * A lock-free bounded ring buffer for many producers and consumers.
+ *
+ * Every slot carries a sequence number telling whether it is free or
+ * filled for the current lap (D. Vyukov's bounded queue). Producers and
+ * consumers claim positions with one compare-and-swap on their cache
+ * line; \c PushN and \c PopN claim a whole run of slots at once.
+ *
+ * Positions are free-running counters, the slot is their dea::CycleWrap
+ * into [0,N): a mask if \c N is a power of two, a division otherwise.
+ *
+ * \tparam T Element type
+ * \tparam N Capacity
+ */
+template <typename T, std::size_t N>
+class MpmcRing
+{
+    static_assert(N > 0,"MpmcRing needs a capacity");
+
+    typedef CycleWrap<std::size_t,0,N-1> SlotWrap;
+
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence_;
+        typename std::aligned_storage<sizeof(T),alignof(T)>::type storage_;
+
+        T* Get() { return reinterpret_cast<T*>(&storage_); }
+    };
+
+    alignas(DEA_CACHE_LINE_SIZE) std::atomic<std::size_t> head_ = {0};
+    alignas(DEA_CACHE_LINE_SIZE) std::atomic<std::size_t> tail_ = {0};
+    alignas(DEA_CACHE_LINE_SIZE) Cell cells_[N];
+
+    public:
+        typedef T ValueType;
+        enum { capacity = N };
+
+        MpmcRing()
+        {
+            for (std::size_t i = 0; i < N; ++i)
+                cells_[i].sequence_.store(i,std::memory_order_relaxed);
+        }
+        MpmcRing(const MpmcRing&) = delete;
+        MpmcRing& operator=(const MpmcRing&) = delete;
+        ~MpmcRing()
+        {
+            const std::size_t tail = tail_.load(std::memory_order_acquire);
+            for (std::size_t head = head_.load(std::memory_order_relaxed);
+                head != tail; ++head)
+                cells_[SlotWrap::Wrapped(head)].Get()->~T();
+        }
+
+        /**
+         * Appends \c item, returns \c false if the ring is full.
+         */
+        template <typename U>
+        bool Push(U&& item)
+        {
+            std::size_t pos;
+            if (!Claim(tail_,0,1,pos))
+                return false;
+            Cell& cell = cells_[SlotWrap::Wrapped(pos)];
+            new (cell.Get()) T(std::forward<U>(item));
+            cell.sequence_.store(pos + 1,std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Appends up to \c n items, returns how many were appended.
+         */
+        std::size_t PushN(const T* items, std::size_t n)
+        {
+            std::size_t pos;
+            const std::size_t count = Claim(tail_,0,n,pos);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                Cell& cell = cells_[SlotWrap::Wrapped(pos + i)];
+                new (cell.Get()) T(items[i]);
+                cell.sequence_.store(pos + i + 1,std::memory_order_release);
+            }
+            return count;
+        }
+
+        /**
+         * Removes the oldest item into \c item, returns \c false if the
+         * ring is empty.
+         */
+        bool Pop(T& item)
+        {
+            std::size_t pos;
+            if (!Claim(head_,1,1,pos))
+                return false;
+            Cell& cell = cells_[SlotWrap::Wrapped(pos)];
+            item = std::move(*cell.Get());
+            cell.Get()->~T();
+            cell.sequence_.store(pos + N,std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Removes up to \c n items into \c items, returns how many were
+         * removed.
+         */
+        std::size_t PopN(T* items, std::size_t n)
+        {
+            std::size_t pos;
+            const std::size_t count = Claim(head_,1,n,pos);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                Cell& cell = cells_[SlotWrap::Wrapped(pos + i)];
+                items[i] = std::move(*cell.Get());
+                cell.Get()->~T();
+                cell.sequence_.store(pos + i + N,std::memory_order_release);
+            }
+            return count;
+        }
+
+    private:
+        /*
+         * Claims up to n consecutive positions starting at `position`
+         * whose cells carry the sequence `pos + offset` (0: free for
+         * producers, 1: filled for consumers). Returns how many were
+         * claimed.
+         */
+        std::size_t Claim(std::atomic<std::size_t>& position,
+            std::size_t offset, std::size_t n, std::size_t& pos)
+        {
+            pos = position.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                std::size_t count = 0;
+                bool behind = false;
+                while (count < n && count < N)
+                {
+                    const std::size_t seq =
+                        cells_[SlotWrap::Wrapped(pos + count)]
+                        .sequence_.load(std::memory_order_acquire);
+                    const std::ptrdiff_t diff =
+                        static_cast<std::ptrdiff_t>(seq - (pos + count + offset));
+                    if (diff != 0)
+                    {
+                        behind = diff > 0;
+                        break;
+                    }
+                    ++count;
+                }
+                if (count == 0 && !behind)
+                    return 0;
+                if (count == 0)
+                {
+                    // another thread took pos already
+                    pos = position.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (position.compare_exchange_weak(pos,pos + count,
+                        std::memory_order_relaxed))
+                    return count;
+            }
+        }
+};
+// }}} class MpmcRing
+
+} // namespace: dea
+
+#endif
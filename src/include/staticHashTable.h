@@ -0,0 +1,324 @@
+/* {{{ LICENSE
+ * staticHashTable.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_STATICHASHTABLE_H
+#define DEA_STATICHASHTABLE_H
+
+// {{{ Includes
+#include "typelist.h"
+#include "typemap.h"
+
+#include <cstdint>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ struct StaticHashEntry
+/*! \struct dea::StaticHashEntry
+ * An entry of a dea::StaticHashTable: the key \c Int2Type<key> and a
+ * type whose static member \c value is the value stored for it, e.g.
+ * another dea::Int2Type or a \c std::integral_constant holding a
+ * function pointer.
+ *
+ * \tparam K dea::Int2Type of the key
+ * \tparam V Type holding the value
+ */
+template <typename K, typename V>
+struct StaticHashEntry;
+template <int key, typename V>
+struct StaticHashEntry<Int2Type<key>,V>
+{
+    typedef Int2Type<key> Key;
+    typedef V Value;
+};
+// }}} struct StaticHashEntry
+
+// {{{ struct StaticHashKeys
+template <typename TList> struct StaticHashKeys;
+template <>
+struct StaticHashKeys<NullType>
+{
+    typedef NullType Result;
+};
+template <typename Head, typename Tail>
+struct StaticHashKeys<Typelist<Head,Tail>>
+{
+    typedef Typelist<typename Head::Key,
+        typename StaticHashKeys<Tail>::Result> Result;
+};
+// }}} struct StaticHashKeys
+
+// {{{ struct StaticHashSearch
+/*! \struct dea::StaticHashSearch
+ * Finds a multiplier \c m and a table size of \c 2^bits for which
+ * \c (key * m) >> (32 - bits) differs for all \c keys: the first
+ * candidate \c t in [0,candidates) with \c Good(t).
+ *
+ * Multiplicative hashing of n keys is only collision-free with good
+ * odds once the table has about n^2 / 2 slots, so the search starts
+ * at the smallest table that fits the keys and doubles it every \c tries
+ * multipliers, up to \c span doublings. Every multiplier costs an
+ * O(n^2) check at compile time, which is what limits tables to
+ * \c maxKeys keys.
+ */
+template <typename Keys>
+struct StaticHashSearch
+{
+    enum
+    {
+        n       = Keys::size,
+        tries   = 64,
+        span    = 10,
+        maxKeys = 128
+    };
+
+    static constexpr unsigned int LowBits(unsigned int bits = 1)
+    { return (1u << bits) >= n ? bits : LowBits(bits + 1); }
+
+    static constexpr std::uint32_t Multiplier(unsigned int t)
+    {
+        return (0x9E3779B1u + (t % tries) * 0x6A09E666u) | 1u;
+    }
+    static constexpr unsigned int Bits(unsigned int t)
+    { return LowBits() + t / tries; }
+
+    static constexpr std::uint32_t Hash(int key, std::uint32_t m,
+        unsigned int bits)
+    {
+        return static_cast<std::uint32_t>(static_cast<std::uint32_t>(key) *
+            m) >> (32 - bits);
+    }
+
+    // no two keys i < j among the pairs i * n + j in [lo,hi) collide
+    static constexpr bool Distinct(std::uint32_t m, unsigned int bits,
+        unsigned int lo, unsigned int hi)
+    {
+        return hi - lo == 1
+            ? lo / n >= lo % n ||
+              Hash(Keys::keys[lo / n],m,bits) !=
+              Hash(Keys::keys[lo % n],m,bits)
+            : Distinct(m,bits,lo,lo + (hi - lo) / 2) &&
+              Distinct(m,bits,lo + (hi - lo) / 2,hi);
+    }
+    static constexpr bool Good(unsigned int t)
+    { return Distinct(Multiplier(t),Bits(t),0,n * n); }
+
+    // the first good candidate in [lo,hi), or hi
+    static constexpr unsigned int First(unsigned int lo, unsigned int hi)
+    {
+        return hi - lo == 1 ? (Good(lo) ? lo : hi)
+            : Either(First(lo,lo + (hi - lo) / 2),lo + (hi - lo) / 2,hi);
+    }
+    static constexpr unsigned int Either(unsigned int left,
+        unsigned int mid, unsigned int hi)
+    { return left != mid ? left : First(mid,hi); }
+
+    enum { candidates = tries * span };
+};
+// }}} struct StaticHashSearch
+
+// {{{ class StaticHashTable
+/*! \class dea::StaticHashTable
+ * A read-only map from sparse integer keys to values, built at compile
+ * time with a perfect hash, so a lookup is one multiply, one shift and
+ * one load from the table instead of the binary search a \c switch
+ * over sparse values compiles into.
+ *
+ * Every slot keeps its key next to its value, which tells keys in the
+ * table from keys that only hash to an occupied slot. Empty slots hold
+ * the first key, which never hashes to them.
+ *
+ * The hash is a single multiply-shift, not a two-level scheme like
+ * hash-and-displace, so the table grows with the square of the number
+ * of keys: 64 random keys take 512 slots, 128 take 2048. Finding the
+ * multiplier takes about as many compile-time steps per try, so a table
+ * holds at most 128 keys. That fits opcodes, error codes or protocol
+ * tags; a switch over hundreds of values is better left as it is.
+ *
+ * Example:
+ * \code
+ * typedef void (*Handler)(const Packet&);
+ * template <Handler h>
+ * using H = std::integral_constant<Handler,h>;
+ *
+ * typedef dea::StaticHashTable<
+ *      dea::TL::MakeTypelist<
+ *          dea::StaticHashEntry<dea::Int2Type<0x01>,H<OnHello>>,
+ *          dea::StaticHashEntry<dea::Int2Type<0x17>,H<OnData>>,
+ *          dea::StaticHashEntry<dea::Int2Type<0x80>,H<OnClose>>>::Result,
+ *      Handler> Handlers;
+ *
+ * if (const Handler* handler = Handlers::Find(packet.tag))
+ *      (*handler)(packet);
+ * \endcode
+ *
+ * \tparam TList dea::Typelist of dea::StaticHashEntry, keys must be
+ * unique
+ * \tparam T Type of the values, a literal type every \c Value::value
+ * converts to
+ */
+template <typename TList, typename T>
+class StaticHashTable
+{
+    static_assert(TL::Length<TList>::value > 0,
+        "StaticHashTable: no entries");
+    static_assert(int(TL::Length<TList>::value) ==
+        int(TL::Length<typename TL::NoDuplicates<
+            typename StaticHashKeys<TList>::Result>::Result>::value),
+        "StaticHashTable: duplicate keys");
+
+    public:
+        typedef T ValueType;
+
+        struct Slot
+        {
+            int key;
+            T value;
+        };
+
+    private:
+        template <typename Indices> struct Entries;
+        template <unsigned int... i>
+        struct Entries<IndexSequence<i...>>
+        {
+            enum { size = sizeof...(i) };
+            static constexpr int keys[sizeof...(i)] =
+                { TL::TypeAt<TList,i>::Result::Key::value... };
+            static constexpr T values[sizeof...(i)] =
+                { TL::TypeAt<TList,i>::Result::Value::value... };
+        };
+        typedef Entries<typename MakeIndexSequence<
+            TL::Length<TList>::value>::Result> Spec;
+        typedef StaticHashSearch<Spec> Search;
+
+        static_assert(int(Spec::size) <= int(Search::maxKeys),
+            "StaticHashTable: at most 128 keys, the table and the search "
+            "for its hash grow with the square of the number of keys");
+        // no search past the limit, the assert is the only error
+        enum
+        {
+            found = int(Spec::size) > int(Search::maxKeys) ? 0
+                : Search::First(0,Search::candidates)
+        };
+        static_assert(int(found) < int(Search::candidates),
+            "StaticHashTable: no collision-free hash found, too many keys");
+
+    public:
+        enum
+        {
+            size  = TL::Length<TList>::value,
+            bits  = Search::Bits(found),
+            slots = 1u << bits
+        };
+        static constexpr std::uint32_t multiplier =
+            Search::Multiplier(found);
+
+    private:
+        static constexpr unsigned int none = size;
+
+        // the entry that hashes to slot s, or none
+        static constexpr unsigned int Owner(unsigned int s,
+            unsigned int lo = 0, unsigned int hi = none)
+        {
+            return hi - lo == 1
+                ? (Search::Hash(Spec::keys[lo],multiplier,bits) == s
+                    ? lo : none)
+                : Pick(Owner(s,lo,lo + (hi - lo) / 2),s,
+                    lo + (hi - lo) / 2,hi);
+        }
+        static constexpr unsigned int Pick(unsigned int left,
+            unsigned int s, unsigned int mid, unsigned int hi)
+        { return left != none ? left : Owner(s,mid,hi); }
+
+        static constexpr Slot Make(unsigned int owner)
+        {
+            return owner == none ? Slot{Spec::keys[0],T()}
+                : Slot{Spec::keys[owner],Spec::values[owner]};
+        }
+
+        template <typename Indices> struct Table;
+        template <unsigned int... s>
+        struct Table<IndexSequence<s...>>
+        {
+            static constexpr Slot table[sizeof...(s)] =
+                { Make(Owner(s))... };
+        };
+        typedef Table<typename MakeIndexSequence<slots>::Result> Slots;
+
+    public:
+        /**
+         * The slot \c key would be in.
+         */
+        static constexpr std::uint32_t Index(int key)
+        { return Search::Hash(key,multiplier,bits); }
+
+        /**
+         * \return The value of \c key, or \c nullptr if it is not in
+         * the table
+         */
+        static const T* Find(int key)
+        {
+            const Slot& slot = Slots::table[Index(key)];
+            return slot.key == key ? &slot.value : nullptr;
+        }
+
+        static constexpr bool Contains(int key)
+        { return Slots::table[Index(key)].key == key; }
+
+        /**
+         * The value of \c key, or \c fallback if it is not in the table.
+         */
+        static constexpr T Get(int key, T fallback)
+        {
+            return Slots::table[Index(key)].key == key
+                ? Slots::table[Index(key)].value : fallback;
+        }
+
+        /**
+         * The value of a key known at compile time.
+         */
+        template <int key>
+        static constexpr T Get()
+        {
+            static_assert(TL::IndexOf<typename StaticHashKeys<TList>::Result,
+                Int2Type<key>>::value >= 0,
+                "StaticHashTable: key not in the table");
+            return Spec::values[TL::IndexOf<typename StaticHashKeys<TList>
+                ::Result,Int2Type<key>>::value];
+        }
+};
+template <typename TList, typename T>
+constexpr std::uint32_t StaticHashTable<TList,T>::multiplier;
+template <typename TList, typename T>
+template <unsigned int... i>
+constexpr int StaticHashTable<TList,T>::Entries<IndexSequence<i...>>::keys[];
+template <typename TList, typename T>
+template <unsigned int... i>
+constexpr T StaticHashTable<TList,T>::Entries<IndexSequence<i...>>::values[];
+template <typename TList, typename T>
+template <unsigned int... s>
+constexpr typename StaticHashTable<TList,T>::Slot
+StaticHashTable<TList,T>::Table<IndexSequence<s...>>::table[];
+// }}} class StaticHashTable
+
+} // namespace: dea
+
+#endif
@@ -0,0 +1,311 @@
+/* {{{ LICENSE
+ * threadPool.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_THREADPOOL_H
+#define DEA_THREADPOOL_H
+
+// {{{ Includes
+#include "cacheLine.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ class ThreadPool
+/*! \class dea::ThreadPool
+ * A work-stealing thread pool.
+ *
+ * Every worker owns a task queue. Tasks submitted by a worker go to its
+ * own queue and are run newest first, tasks from other threads are
+ * spread round-robin. A worker whose queue runs dry steals the oldest
+ * task of another one.
+ *
+ * Use dea::TaskGroup to wait for a set of tasks. The destructor runs all
+ * queued tasks before joining the workers.
+ */
+class ThreadPool
+{
+    typedef std::function<void()> Task;
+
+    // padded instead of aligned, new[] ignores extended alignment
+    // before C++17
+    struct Queue
+    {
+        std::mutex mutex_;
+        std::deque<Task> tasks_;
+        char padding_[DEA_CACHE_LINE_SIZE];
+    };
+
+    struct Worker
+    {
+        const ThreadPool* pool;
+        std::size_t index;
+    };
+
+    std::unique_ptr<Queue[]> queues_;
+    std::size_t size_;
+    std::vector<std::thread> threads_;
+    std::atomic<std::size_t> queued_ = {0};
+    std::atomic<std::size_t> next_ = {0};
+    std::mutex sleepMutex_;
+    std::condition_variable sleep_;
+    bool stop_ = false;
+
+    public:
+        /**
+         * \param threads Number of workers, at least one
+         */
+        explicit ThreadPool(
+            unsigned int threads = std::thread::hardware_concurrency())
+            : queues_{new Queue[threads ? threads : 1]},
+              size_{threads ? threads : 1}
+        {
+            threads_.reserve(size_);
+            for (std::size_t i = 0; i < size_; ++i)
+                threads_.emplace_back(&ThreadPool::Work,this,i);
+        }
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex_);
+                stop_ = true;
+            }
+            sleep_.notify_all();
+            for (std::thread& thread : threads_)
+                thread.join();
+        }
+
+        /**
+         * Number of workers.
+         */
+        std::size_t Size() const { return size_; }
+
+        /**
+         * Queues \c task. It must not throw.
+         */
+        void Submit(Task task)
+        {
+            const Worker& self = Self();
+            const std::size_t index = self.pool == this ? self.index :
+                next_.fetch_add(1,std::memory_order_relaxed) % size_;
+            // counted before it is visible, so a thief taking it right
+            // away cannot bring queued_ below zero
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex_);
+                queued_.fetch_add(1,std::memory_order_relaxed);
+            }
+            try
+            {
+                std::lock_guard<std::mutex> lock(queues_[index].mutex_);
+                queues_[index].tasks_.push_back(std::move(task));
+            }
+            catch (...)
+            {
+                queued_.fetch_sub(1,std::memory_order_relaxed);
+                throw;
+            }
+            sleep_.notify_one();
+        }
+
+        /**
+         * Runs one queued task on the calling thread, returns \c false
+         * if there was none. Lets waiting threads help out.
+         */
+        bool RunOne()
+        {
+            const Worker& self = Self();
+            const std::size_t first = self.pool == this ? self.index :
+                next_.load(std::memory_order_relaxed) % size_;
+            Task task;
+            for (std::size_t i = 0; i < size_; ++i)
+            {
+                const std::size_t index = (first + i) % size_;
+                if (Take(queues_[index],index == self.index &&
+                        self.pool == this,task))
+                {
+                    queued_.fetch_sub(1,std::memory_order_relaxed);
+                    task();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        static Worker& Self()
+        {
+            static thread_local Worker self{nullptr,0};
+            return self;
+        }
+
+        static bool Take(Queue& queue, bool own, Task& task)
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex_);
+            if (queue.tasks_.empty())
+                return false;
+            if (own)
+            {
+                task = std::move(queue.tasks_.back());
+                queue.tasks_.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.tasks_.front());
+                queue.tasks_.pop_front();
+            }
+            return true;
+        }
+
+        void Work(std::size_t index)
+        {
+            Self() = Worker{this,index};
+            for (;;)
+            {
+                if (RunOne())
+                    continue;
+                std::unique_lock<std::mutex> lock(sleepMutex_);
+                if (stop_ && queued_.load(std::memory_order_relaxed) == 0)
+                    return;
+                sleep_.wait(lock,[this]{ return stop_ ||
+                    queued_.load(std::memory_order_relaxed) > 0; });
+            }
+        }
+};
+// }}} class ThreadPool
+
+// {{{ class TaskGroup
+/*! \class dea::TaskGroup
+ * A set of tasks on a dea::ThreadPool that can be waited for.
+ *
+ * \c Wait runs queued tasks while it waits, so groups may be nested
+ * inside tasks without running out of workers. The first exception
+ * thrown by a task is rethrown by \c Wait.
+ *
+ * Example:
+ * \code
+ * dea::TaskGroup group(pool);
+ * for (auto& part : parts)
+ *     group.Run([&part]{ part.Build(); });
+ * group.Wait();
+ * \endcode
+ */
+class TaskGroup
+{
+    ThreadPool& pool_;
+    std::atomic<std::size_t> pending_ = {0};
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::exception_ptr error_;
+
+    public:
+        explicit TaskGroup(ThreadPool& pool) : pool_(pool) {}
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+        ~TaskGroup()
+        {
+            try { Wait(); } catch (...) {}
+        }
+
+        /**
+         * Submits \c task to the pool.
+         */
+        template <typename F>
+        void Run(F task)
+        {
+            pending_.fetch_add(1,std::memory_order_relaxed);
+            try
+            {
+                Submit(task);
+            }
+            catch (...)
+            {
+                pending_.fetch_sub(1,std::memory_order_relaxed);
+                throw;
+            }
+        }
+
+        /**
+         * Waits until every task has finished, helping the pool in the
+         * meantime.
+         * \throws the first exception thrown by a task
+         */
+        void Wait()
+        {
+            while (pending_.load(std::memory_order_acquire) != 0)
+            {
+                if (pool_.RunOne())
+                    continue;
+                // nothing left to help with: the remaining tasks are
+                // running, and the last one notifies under mutex_
+                std::unique_lock<std::mutex> lock(mutex_);
+                done_.wait(lock,[this]
+                    { return pending_.load(std::memory_order_acquire) == 0; });
+            }
+            // the last task may still hold the mutex
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (error_)
+            {
+                std::exception_ptr error = error_;
+                error_ = nullptr;
+                std::rethrow_exception(error);
+            }
+        }
+
+    private:
+        template <typename F>
+        void Submit(const F& task)
+        {
+            pool_.Submit([this,task]
+            {
+                try
+                {
+                    task();
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (!error_)
+                        error_ = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (pending_.fetch_sub(1,std::memory_order_acq_rel) == 1)
+                    done_.notify_all();
+            });
+        }
+};
+// }}} class TaskGroup
+
+} // namespace: dea
+
+#endif
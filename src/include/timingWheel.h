@@ -0,0 +1,279 @@
+/* {{{ LICENSE
+ * timingWheel.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_TIMINGWHEEL_H
+#define DEA_TIMINGWHEEL_H
+
+// {{{ Includes
+#include "cycle.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ struct TimerId
+/*! \struct dea::TimerId
+ * Handle of a timer scheduled on a dea::TimingWheel.
+ * Stays safe to cancel after the timer fired or was cancelled.
+ */
+struct TimerId
+{
+    std::uint32_t index;
+    std::uint32_t generation;
+};
+// }}} struct TimerId
+
+// {{{ class TimingWheel
+/*! \class dea::TimingWheel
+ * A hierarchical timing wheel with O(1) schedule, cancel and tick.
+ *
+ * Every level has 2^slotBits slots and a dea::StaticCycle cursor with
+ * dea::StaticCountMaxOverload. Level 0 advances once per tick; when a
+ * level's cursor wraps the next level's cursor advances and the timers
+ * of its new slot cascade down into the lower levels. Timers further
+ * away than all levels cover wait in the top level and cascade again.
+ *
+ * The wheel knows no clock. Time is a tick count moved by \c Advance,
+ * so it runs just as well on simulated time:
+ * \code
+ * dea::TimingWheel<> wheel;
+ * auto id = wheel.Schedule(250,[]{ std::puts("timeout"); });
+ * wheel.Cancel(id);
+ * wheel.Advance(1000);
+ * \endcode
+ *
+ * Callbacks run inside \c Advance and may schedule and cancel timers.
+ *
+ * \tparam Callback Callable invoked when a timer fires
+ * \tparam slotBits log2 of the number of slots per level
+ * \tparam levels Number of levels
+ */
+template <typename Callback = std::function<void()>,
+    unsigned int slotBits = 8, unsigned int levels = 4>
+class TimingWheel
+{
+    static_assert(slotBits > 0 && levels > 0 && slotBits * levels < 64,
+        "TimingWheel needs 0 < slotBits * levels < 64");
+
+    public:
+        typedef std::uint64_t Tick;
+
+        enum { slots = 1u << slotBits };
+
+    private:
+        typedef StaticCycle<unsigned int,0,slots-1,1,StaticCountMaxOverload>
+            Cursor;
+
+        static const std::uint32_t npos = 0xFFFFFFFFu;
+
+        struct Node
+        {
+            Tick expiry;
+            Callback callback;
+            std::uint32_t prev;
+            std::uint32_t next;
+            std::uint32_t list;
+            std::uint32_t generation;
+        };
+
+        Tick now_ = 0;
+        std::size_t size_ = 0;
+        std::vector<Node> nodes_;
+        std::uint32_t free_ = npos;
+        std::uint32_t heads_[levels * slots];
+        Cursor cursors_[levels];
+        std::shared_ptr<std::size_t> wraps_[levels];
+
+    public:
+        TimingWheel()
+        {
+            for (std::uint32_t& head : heads_)
+                head = npos;
+            for (unsigned int l = 0; l < levels; ++l)
+            {
+                wraps_[l] = std::make_shared<std::size_t>(0);
+                cursors_[l] = 0u;
+                cursors_[l].setCounter(wraps_[l]);
+            }
+        }
+        TimingWheel(const TimingWheel&) = delete;
+        TimingWheel& operator=(const TimingWheel&) = delete;
+
+        /**
+         * Current tick.
+         */
+        Tick Now() const { return now_; }
+        /**
+         * Number of pending timers.
+         */
+        std::size_t Size() const { return size_; }
+
+        /**
+         * Schedules \c callback to run \c delay ticks from now.
+         * A delay of 0 fires on the next tick.
+         */
+        TimerId Schedule(Tick delay, Callback callback)
+        {
+            std::uint32_t index = free_;
+            if (index != npos)
+                free_ = nodes_[index].next;
+            else
+            {
+                index = static_cast<std::uint32_t>(nodes_.size());
+                nodes_.push_back(Node{0,Callback{},npos,npos,npos,0});
+            }
+            Node& node = nodes_[index];
+            node.expiry = now_ + (delay ? delay : 1);
+            node.callback = std::move(callback);
+            Place(index);
+            ++size_;
+            return TimerId{index,node.generation};
+        }
+
+        /**
+         * Cancels a pending timer. Returns \c false if it already fired
+         * or was cancelled.
+         */
+        bool Cancel(TimerId id)
+        {
+            if (id.index >= nodes_.size())
+                return false;
+            Node& node = nodes_[id.index];
+            if (node.generation != id.generation || node.list == npos)
+                return false;
+            Unlink(id.index);
+            Release(id.index);
+            return true;
+        }
+
+        /**
+         * Moves time forward by \c ticks, firing every timer that
+         * expires on the way.
+         */
+        void Advance(Tick ticks = 1)
+        {
+            while (ticks--)
+                Tick1();
+        }
+
+    private:
+        void Tick1()
+        {
+            ++now_;
+            for (unsigned int l = 0; l < levels; ++l)
+            {
+                const std::size_t before = *wraps_[l];
+                ++cursors_[l];
+                if (l > 0)
+                    Cascade(l);
+                if (*wraps_[l] == before)
+                    break;
+            }
+
+            std::uint32_t& head = heads_[cursors_[0]()];
+            while (head != npos)
+            {
+                const std::uint32_t index = head;
+                Unlink(index);
+                if (nodes_[index].expiry != now_)
+                {
+                    // parked beyond the reach of a single level wheel
+                    Place(index);
+                    continue;
+                }
+                Callback callback = std::move(nodes_[index].callback);
+                Release(index);
+                callback();
+            }
+        }
+
+        // moves the timers of the current slot of `level` down
+        void Cascade(unsigned int level)
+        {
+            std::uint32_t& head = heads_[level * slots + cursors_[level]()];
+            std::uint32_t index = head;
+            head = npos;
+            while (index != npos)
+            {
+                const std::uint32_t next = nodes_[index].next;
+                Place(index);
+                index = next;
+            }
+        }
+
+        void Place(std::uint32_t index)
+        {
+            Node& node = nodes_[index];
+            const Tick delta = node.expiry - now_;
+            unsigned int level = 0;
+            while (level + 1 < levels &&
+                    delta >= (Tick(1) << ((level + 1) * slotBits)))
+                ++level;
+
+            // beyond the top level: park as far out as it reaches
+            const Tick reach = Tick(1) << (levels * slotBits);
+            const Tick when = delta < reach ? node.expiry : now_ + reach - 1;
+            const std::uint32_t list = level * slots +
+                ((when >> (level * slotBits)) & (slots - 1));
+
+            node.list = list;
+            node.prev = npos;
+            node.next = heads_[list];
+            if (node.next != npos)
+                nodes_[node.next].prev = index;
+            heads_[list] = index;
+        }
+
+        void Unlink(std::uint32_t index)
+        {
+            Node& node = nodes_[index];
+            if (node.prev != npos)
+                nodes_[node.prev].next = node.next;
+            else
+                heads_[node.list] = node.next;
+            if (node.next != npos)
+                nodes_[node.next].prev = node.prev;
+            node.list = npos;
+        }
+
+        void Release(std::uint32_t index)
+        {
+            Node& node = nodes_[index];
+            node.callback = Callback{};
+            ++node.generation;
+            node.next = free_;
+            free_ = index;
+            --size_;
+        }
+};
+template <typename Callback, unsigned int slotBits, unsigned int levels>
+const std::uint32_t TimingWheel<Callback,slotBits,levels>::npos;
+// }}} class TimingWheel
+
+} // namespace: dea
+
+#endif
@@ -0,0 +1,376 @@
+/* {{{ LICENSE
+ * tupleFile.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_TUPLEFILE_H
+#define DEA_TUPLEFILE_H
+
+// {{{ Includes
+#include "hierarchy.h"
+#include "nullType.h"
+#include "typelist.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ struct SchemaTraits
+/*! \struct dea::SchemaTraits
+ * Describes a field type for the schema fingerprint of a
+ * dea::TupleFile.
+ *
+ * The default tells integers, floating point numbers, enums and other
+ * types apart and mixes in size and alignment. Specialize it for your
+ * own structs to tell equally shaped ones apart:
+ * \code
+ * template <> struct dea::SchemaTraits<Vec3>
+ * { static constexpr std::uint64_t id = 0x56656333; };
+ * \endcode
+ *
+ * \tparam T Field type
+ */
+template <typename T>
+struct SchemaTraits
+{
+    static constexpr std::uint64_t id =
+        std::is_floating_point<T>::value ? 1 :
+        std::is_integral<T>::value ? (std::is_signed<T>::value ? 2 : 3) :
+        std::is_enum<T>::value ? 4 : 5;
+};
+template <typename T>
+constexpr std::uint64_t SchemaTraits<T>::id;
+// }}} struct SchemaTraits
+
+// {{{ namespace: TL
+namespace TL
+{
+    // {{{ struct IsTriviallyCopyable
+    /*! \struct dea::TL::IsTriviallyCopyable
+     * Tells whether every type of a dea::Typelist is trivially copyable.
+     * You can access the result by
+     * \c dea::TL::IsTriviallyCopyable<TList>::value
+     *
+     * \tparam TList dea::Typelist to check
+     */
+    template <typename TList> struct IsTriviallyCopyable;
+    template <>
+    struct IsTriviallyCopyable<NullType>
+    {
+        enum { value = true };
+    };
+    template <typename Head, typename Tail>
+    struct IsTriviallyCopyable<Typelist<Head,Tail>>
+    {
+        enum { value = std::is_trivially_copyable<Head>::value &&
+            IsTriviallyCopyable<Tail>::value };
+    };
+    // }}} struct IsTriviallyCopyable
+
+    // {{{ struct Fingerprint
+    /*! \struct dea::TL::Fingerprint
+     * A 64 bit FNV-1a hash over the dea::SchemaTraits, sizes and
+     * alignments of the types of a dea::Typelist, in order.
+     * You can access it by \c dea::TL::Fingerprint<TList>::value
+     *
+     * \tparam TList dea::Typelist to fingerprint
+     */
+    template <typename TList> struct Fingerprint;
+    template <>
+    struct Fingerprint<NullType>
+    {
+        static constexpr std::uint64_t value = 14695981039346656037ull;
+
+        static constexpr std::uint64_t Mix(std::uint64_t h, std::uint64_t v)
+        { return (h ^ v) * 1099511628211ull; }
+    };
+    template <typename Head, typename Tail>
+    struct Fingerprint<Typelist<Head,Tail>>
+    {
+        static constexpr std::uint64_t value =
+            Fingerprint<NullType>::Mix(Fingerprint<NullType>::Mix(
+                Fingerprint<NullType>::Mix(Fingerprint<Tail>::value,
+                    SchemaTraits<Head>::id),sizeof(Head)),alignof(Head));
+    };
+    // }}} struct Fingerprint
+}
+// }}} namespace: TL
+
+// {{{ struct TupleFileHeader
+/*! \struct dea::TupleFileHeader
+ * The 64 byte header in front of the records of a dea::TupleFile.
+ */
+struct TupleFileHeader
+{
+    char          magic[8];     ///< "cDeaTup\0"
+    std::uint32_t byteOrder;    ///< 0x01020304 in the writer's order
+    std::uint32_t alignment;    ///< Alignment of the records
+    std::uint64_t fingerprint;  ///< dea::TL::Fingerprint of the schema
+    std::uint64_t recordSize;   ///< sizeof one record
+    std::uint64_t count;        ///< Number of records
+    char          reserved[24];
+};
+static_assert(sizeof(TupleFileHeader) == 64,
+    "TupleFileHeader has to be 64 bytes");
+// }}} struct TupleFileHeader
+
+// {{{ struct TupleFile
+/*! \struct dea::TupleFile
+ * Binary files of dea::Tuple records that load without copying.
+ *
+ * Records are written as raw bytes, one write per block, behind a
+ * dea::TupleFileHeader holding a schema fingerprint computed from the
+ * dea::Typelist. \c View maps such a file read-only and hands out the
+ * records in place. Both need a trivially copyable dea::Typelist, which
+ * is checked at compile time.
+ *
+ * Example:
+ * \code
+ * typedef typename dea::TL::MakeTypelist<int,double,char>::Result Row;
+ *
+ * dea::TupleFile<Row>::Writer writer("rows.bin");
+ * writer.Write(rows.data(),rows.size());
+ * writer.Close();
+ *
+ * dea::TupleFile<Row>::View view("rows.bin");
+ * for (const dea::Tuple<Row>& row : view) ...
+ * \endcode
+ *
+ * The files are meant for the machine (or ABI) that wrote them: a
+ * different byte order, record size or fingerprint is rejected.
+ *
+ * \tparam TList dea::Typelist of the record fields
+ */
+template <typename TList>
+struct TupleFile
+{
+    static_assert(TL::IsTriviallyCopyable<TList>::value,
+        "TupleFile needs a typelist of trivially copyable types");
+
+    typedef Tuple<TList> Record;
+
+    static_assert(alignof(Record) <= sizeof(TupleFileHeader),
+        "TupleFile records may be aligned to 64 bytes at most");
+
+    enum { recordSize = sizeof(Record) };
+
+    static constexpr std::uint64_t fingerprint =
+        TL::Fingerprint<TList>::value ^ sizeof(Record);
+
+    /**
+     * Copies \c n records into \c out with one memcpy, returns the
+     * number of bytes written.
+     */
+    static std::size_t Serialize(const Record* records, std::size_t n,
+        void* out)
+    {
+        std::memcpy(out,records,n * sizeof(Record));
+        return n * sizeof(Record);
+    }
+
+    // {{{ class Writer
+    /*! \class dea::TupleFile::Writer
+     * Writes a file of records, creating or truncating it.
+     * \throws std::system_error on I/O errors
+     */
+    class Writer
+    {
+        int fd_ = -1;
+        std::uint64_t count_ = 0;
+
+        public:
+            explicit Writer(const char* path)
+            {
+                fd_ = ::open(path,O_WRONLY | O_CREAT | O_TRUNC,0644);
+                if (fd_ < 0)
+                    Fail("open");
+                const TupleFileHeader header = MakeHeader(0);
+                try
+                {
+                    WriteAll(&header,sizeof(header));
+                }
+                catch (...)
+                {
+                    ::close(fd_);
+                    throw;
+                }
+            }
+            Writer(const Writer&) = delete;
+            Writer& operator=(const Writer&) = delete;
+            ~Writer() noexcept
+            {
+                try { Close(); } catch (...) {}
+            }
+
+            /**
+             * Appends \c n records with a single write.
+             */
+            void Write(const Record* records, std::size_t n)
+            {
+                WriteAll(records,n * sizeof(Record));
+                count_ += n;
+            }
+            void Write(const Record& record) { Write(&record,1); }
+
+            /**
+             * Stores the record count in the header and closes the
+             * file.
+             */
+            void Close()
+            {
+                if (fd_ < 0)
+                    return;
+                const TupleFileHeader header = MakeHeader(count_);
+                const int fd = fd_;
+                fd_ = -1;
+                if (::pwrite(fd,&header,sizeof(header),0)
+                        != static_cast<ssize_t>(sizeof(header)))
+                {
+                    ::close(fd);
+                    Fail("pwrite");
+                }
+                if (::close(fd) != 0)
+                    Fail("close");
+            }
+
+        private:
+            void WriteAll(const void* data, std::size_t size)
+            {
+                const char* p = static_cast<const char*>(data);
+                while (size > 0)
+                {
+                    const ssize_t n = ::write(fd_,p,size);
+                    if (n < 0 && errno == EINTR)
+                        continue;
+                    if (n < 0)
+                        Fail("write");
+                    p += n;
+                    size -= static_cast<std::size_t>(n);
+                }
+            }
+    };
+    // }}} class Writer
+
+    // {{{ class View
+    /*! \class dea::TupleFile::View
+     * Maps a file of records read-only and gives typed access to them
+     * without copying.
+     * \throws std::system_error on I/O errors
+     * \throws std::runtime_error if the file does not match the schema
+     */
+    class View
+    {
+        void* map_ = MAP_FAILED;
+        std::size_t mapSize_ = 0;
+        const Record* records_ = nullptr;
+        std::size_t count_ = 0;
+
+        public:
+            explicit View(const char* path)
+            {
+                const int fd = ::open(path,O_RDONLY);
+                if (fd < 0)
+                    Fail("open");
+                struct stat st;
+                if (::fstat(fd,&st) != 0)
+                {
+                    ::close(fd);
+                    Fail("fstat");
+                }
+                mapSize_ = static_cast<std::size_t>(st.st_size);
+                if (mapSize_ < sizeof(TupleFileHeader))
+                {
+                    ::close(fd);
+                    throw std::runtime_error("TupleFile: file too short");
+                }
+                map_ = ::mmap(nullptr,mapSize_,PROT_READ,MAP_PRIVATE,fd,0);
+                ::close(fd);
+                if (map_ == MAP_FAILED)
+                    Fail("mmap");
+
+                const TupleFileHeader& header =
+                    *static_cast<const TupleFileHeader*>(map_);
+                const TupleFileHeader expected = MakeHeader(header.count);
+                if (std::memcmp(&header,&expected,sizeof(header)) != 0 ||
+                    header.count > (mapSize_ - sizeof(header)) / sizeof(Record))
+                {
+                    ::munmap(map_,mapSize_);
+                    throw std::runtime_error("TupleFile: schema mismatch");
+                }
+                records_ = reinterpret_cast<const Record*>(
+                    static_cast<const char*>(map_) + sizeof(header));
+                count_ = static_cast<std::size_t>(header.count);
+            }
+            View(const View&) = delete;
+            View& operator=(const View&) = delete;
+            ~View() noexcept
+            {
+                if (map_ != MAP_FAILED)
+                    ::munmap(map_,mapSize_);
+            }
+
+            std::size_t Size() const { return count_; }
+            const Record* Data() const { return records_; }
+            const Record& operator[](std::size_t i) const
+                { return records_[i]; }
+            const Record* begin() const { return records_; }
+            const Record* end() const { return records_ + count_; }
+    };
+    // }}} class View
+
+    private:
+        static TupleFileHeader MakeHeader(std::uint64_t count)
+        {
+            TupleFileHeader header;
+            std::memset(&header,0,sizeof(header));
+            std::memcpy(header.magic,"cDeaTup",8);
+            header.byteOrder = 0x01020304u;
+            header.alignment = alignof(Record);
+            header.fingerprint = fingerprint;
+            header.recordSize = sizeof(Record);
+            header.count = count;
+            return header;
+        }
+
+        static void Fail(const char* what)
+        {
+            throw std::system_error(errno,std::system_category(),
+                std::string("TupleFile: ") + what);
+        }
+};
+template <typename TList>
+constexpr std::uint64_t TupleFile<TList>::fingerprint;
+// }}} struct TupleFile
+
+} // namespace: dea
+
+#endif
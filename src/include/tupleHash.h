@@ -0,0 +1,187 @@
+/* {{{ LICENSE
+ * tupleHash.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_TUPLEHASH_H
+#define DEA_TUPLEHASH_H
+
+// {{{ Includes
+#include "hierarchy.h"
+#include "typelist.h"
+#include "typemap.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+// }}} Includes
+
+namespace dea
+{
+
+// {{{ HashBytes
+/**
+ * Hashes \c size bytes at \c data, eight at a time.
+ */
+inline std::uint64_t HashBytes(const void* data, std::size_t size,
+    std::uint64_t seed)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    std::uint64_t h = seed ^ (size * 0x9E3779B97F4A7C15ull);
+    for (; size >= 8; size -= 8, p += 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word,p,8);
+        h = (h ^ word) * 0x9E3779B97F4A7C15ull;
+        h ^= h >> 32;
+    }
+    if (size > 0)
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word,p,size);
+        h = (h ^ word) * 0x9E3779B97F4A7C15ull;
+        h ^= h >> 32;
+    }
+    return h;
+}
+// }}} HashBytes
+
+// {{{ struct Hash
+/*! \struct dea::Hash
+ * Hash functor, \c std::hash unless specialized.
+ *
+ * \tparam T Type to hash
+ */
+template <typename T>
+struct Hash
+{
+    std::size_t operator()(const T& value) const
+    { return std::hash<T>()(value); }
+};
+
+// {{{ struct TupleHashState
+/*! \struct dea::TupleHashState
+ * Collects the fields of a dea::Tuple for dea::Hash. Adjacent fields
+ * of the same bytes for equal values are gathered into one block and
+ * hashed at once. The field addresses are known at compile time, so
+ * the gathering folds away.
+ */
+struct TupleHashState
+{
+    std::uint64_t hash = 0x243F6A8885A308D3ull;
+    const char* begin = nullptr;
+    const char* end = nullptr;
+
+    void Block(const void* data, std::size_t size)
+    {
+        const char* p = static_cast<const char*>(data);
+        if (p != end)
+        {
+            Flush();
+            begin = p;
+        }
+        end = p + size;
+    }
+    void Value(std::uint64_t value)
+    {
+        Flush();
+        hash = (hash ^ value) * 0x9E3779B97F4A7C15ull;
+        hash ^= hash >> 32;
+    }
+    void Flush()
+    {
+        if (begin != end)
+            hash = HashBytes(begin,static_cast<std::size_t>(end - begin),hash);
+        begin = end = nullptr;
+    }
+    std::uint64_t Finish()
+    {
+        Flush();
+        // MurmurHash3 finalizer
+        std::uint64_t h = hash;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    }
+};
+// }}} struct TupleHashState
+
+template <typename TList, unsigned int i = 0,
+    unsigned int n = TL::Length<TList>::value>
+struct TupleHashHelper
+{
+    typedef typename TL::TypeAt<TList,i>::Result FieldType;
+
+    // equal values are equal bytes without padding
+    enum
+    {
+        bytewise = std::is_integral<FieldType>::value ||
+            std::is_enum<FieldType>::value ||
+            std::is_pointer<FieldType>::value
+    };
+
+    static void Do(const Tuple<TList>& tuple, TupleHashState& state)
+    {
+        Add(Field<i>(tuple),state,Int2Type<bytewise>());
+        TupleHashHelper<TList,i+1,n>::Do(tuple,state);
+    }
+
+    private:
+        static void Add(const FieldType& field, TupleHashState& state,
+            Int2Type<true>)
+        { state.Block(&field,sizeof(field)); }
+        static void Add(const FieldType& field, TupleHashState& state,
+            Int2Type<false>)
+        { state.Value(Hash<FieldType>()(field)); }
+};
+template <typename TList, unsigned int n>
+struct TupleHashHelper<TList,n,n>
+{
+    static void Do(const Tuple<TList>&, TupleHashState&) {}
+};
+
+/*! \struct dea::Hash<Tuple<TList>>
+ * Hashes a dea::Tuple field by field.
+ *
+ * Runs of adjacent integer, enum and pointer fields are hashed as one
+ * block of bytes; every other field is hashed by its own dea::Hash and
+ * mixed in. Floating point fields go through dea::Hash, since 0.0 and
+ * -0.0 compare equal.
+ *
+ * \tparam TList dea::Typelist of the tuple
+ */
+template <typename TList>
+struct Hash<Tuple<TList>>
+{
+    std::size_t operator()(const Tuple<TList>& tuple) const
+    {
+        TupleHashState state;
+        TupleHashHelper<TList>::Do(tuple,state);
+        return static_cast<std::size_t>(state.Finish());
+    }
+};
+// }}} struct Hash
+
+} // namespace: dea
+
+#endif
@@ -21,6 +21,10 @@
 #ifndef DEA_TYPEMAP_H
 #define DEA_TYPEMAP_H
 
+// {{{ Includes
+#include <cstddef>
+// }}} Includes
+
 namespace dea
 {
 
@@ -36,6 +40,161 @@ struct Int2Type
 };
 // }}} struct Int2Type
 
+// {{{ struct IndexSequence
+/*! \struct dea::IndexSequence
+ * A compile-time sequence of indices, used to expand parameter packs.
+ *
+ * Use dea::MakeIndexSequence to create one:
+ * \code
+ * typedef typename dea::MakeIndexSequence<4>::Result Indices;
+ *      // dea::IndexSequence<0,1,2,3>
+ * \endcode
+ *
+ * \tparam i Indices
+ */
+template <unsigned int... i>
+struct IndexSequence
+{
+    enum { size = sizeof...(i) /*!< Number of indices.*/ };
+};
+
+template <typename L, typename R> struct ConcatIndexSequence;
+template <unsigned int... i, unsigned int... j>
+struct ConcatIndexSequence<IndexSequence<i...>,IndexSequence<j...>>
+{
+    typedef IndexSequence<i...,(sizeof...(i)+j)...> Result;
+};
+
+/*! \struct dea::MakeIndexSequence
+ * Creates the dea::IndexSequence 0..n-1 with logarithmic recursion
+ * depth. You can access it by \c dea::MakeIndexSequence<n>::Result
+ *
+ * \tparam n Length of the sequence
+ */
+template <unsigned int n>
+struct MakeIndexSequence
+{
+    typedef typename ConcatIndexSequence<
+        typename MakeIndexSequence<n/2>::Result,
+        typename MakeIndexSequence<n-n/2>::Result>::Result Result;
+};
+template <>
+struct MakeIndexSequence<0>
+{
+    typedef IndexSequence<> Result;
+};
+template <>
+struct MakeIndexSequence<1>
+{
+    typedef IndexSequence<0> Result;
+};
+// }}} struct IndexSequence
+
+// {{{ struct StaticFor
+/*! \struct dea::StaticFor
+ * A loop over [Begin,End) in steps of \c Step, unrolled at compile
+ * time. The body gets the index as a dea::Int2Type, so it can be used
+ * as a template argument and index-dependent code resolves statically.
+ *
+ * Example:
+ * \code
+ * struct Row
+ * {
+ *     const float (&m)[4][4]; const float (&v)[4]; float (&out)[4];
+ *     template <int i>
+ *     void operator()(dea::Int2Type<i>) const
+ *     { out[i] = m[i][0]*v[0] + m[i][1]*v[1] + m[i][2]*v[2] + m[i][3]*v[3]; }
+ * };
+ *
+ * dea::StaticFor<0,4>::Do(Row{m,v,out});
+ * \endcode
+ *
+ * The calls are expanded from a dea::IndexSequence, not by recursion,
+ * and happen in order.
+ *
+ * \tparam Begin First index
+ * \tparam End Index to stop at, not included
+ * \tparam Step Stride, may be negative
+ */
+template <int Begin, int End, int Step = 1>
+struct StaticFor
+{
+    static_assert(Step != 0,"StaticFor needs a non-zero step");
+
+    enum
+    {
+        count = Step > 0
+            ? (End > Begin ? (End - Begin + Step - 1) / Step : 0)
+            : (Begin > End ? (Begin - End - Step - 1) / -Step : 0)
+    };
+
+    template <typename F>
+    static void Do(F&& f)
+    { Expand(f,typename MakeIndexSequence<count>::Result()); }
+
+    private:
+        template <typename F, unsigned int... i>
+        static void Expand(F& f, IndexSequence<i...>)
+        {
+            // braced initializers are evaluated in order
+            const int order[] = { 0,((void)f(
+                Int2Type<Begin + static_cast<int>(i) * Step>()),0)... };
+            (void)order;
+        }
+};
+// }}} struct StaticFor
+
+// {{{ struct Unroll
+/*! \struct dea::Unroll
+ * Repeats a body \c N times at compile time.
+ *
+ * \c Do calls the body with dea::Int2Type<0> up to dea::Int2Type<N-1>.
+ * \c Loop runs a loop with a runtime trip count, \c N iterations per
+ * step plus a rolled remainder:
+ * \code
+ * dea::Unroll<16>::Loop(n,[&](std::size_t i) { sum[i % 16] += data[i]; });
+ * \endcode
+ *
+ * \tparam N Unroll factor
+ */
+template <unsigned int N>
+struct Unroll
+{
+    static_assert(N > 0,"Unroll needs a factor");
+
+    enum { factor = N };
+
+    template <typename F>
+    static void Do(F&& f)
+    { StaticFor<0,static_cast<int>(N)>::Do(f); }
+
+    /**
+     * Calls \c f(i) for every \c i in [0,n) in order.
+     */
+    template <typename F>
+    static void Loop(std::size_t n, F&& f)
+    {
+        std::size_t i = 0;
+        for (; n - i >= N; i += N)
+            Do(Offset<F>{f,i});
+        for (; i < n; ++i)
+            f(i);
+    }
+
+    private:
+        template <typename F>
+        struct Offset
+        {
+            F& f;
+            std::size_t base;
+
+            template <int k>
+            void operator()(Int2Type<k>) const
+            { f(base + static_cast<std::size_t>(k)); }
+        };
+};
+// }}} struct Unroll
+
 // {{{ struct Type2Type
 /*!
  * Lets you map a type to a type.
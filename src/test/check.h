@@ -0,0 +1,60 @@
+/* {{{ LICENSE
+ * check.h
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+#ifndef DEA_TEST_CHECK_H
+#define DEA_TEST_CHECK_H
+
+// {{{ Includes
+#include <cstdio>
+// }}} Includes
+
+/*
+ * Minimal checks for the cDea tests: DEA_CHECK reports a failed
+ * condition with its location and keeps going, DEA_CHECK_RESULT is what
+ * main returns.
+ */
+
+namespace dea
+{
+namespace test
+{
+
+inline int& Failures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+inline void Check(bool ok, const char* what, const char* file, int line)
+{
+    if (ok)
+        return;
+    std::fprintf(stderr,"%s:%d: check failed: %s\n",file,line,what);
+    ++Failures();
+}
+
+} // namespace: test
+} // namespace: dea
+
+#define DEA_CHECK(condition) \
+    ::dea::test::Check((condition),#condition,__FILE__,__LINE__)
+#define DEA_CHECK_RESULT (::dea::test::Failures() == 0 ? 0 : 1)
+
+#endif
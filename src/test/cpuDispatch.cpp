@@ -0,0 +1,149 @@
+/* {{{ LICENSE
+ * cpuDispatch.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::CpuDispatch: overriding dea::CpuFeatures selects every kernel in
+ * turn, and each kernel the CPU can run sums like the scalar one.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "cpuDispatch.h"
+#include "typelist.h"
+
+#include <cstddef>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DEA_TEST_X86 1
+#include <immintrin.h>
+#endif
+// }}} Includes
+
+namespace
+{
+
+struct SumScalar
+{
+    enum { required = dea::CpuNone };
+
+    static int Run(const int* p, std::size_t n)
+    {
+        int sum = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            sum += p[i];
+        return sum;
+    }
+};
+
+struct SumSse2
+{
+    enum { required = dea::CpuSse2 };
+
+    DEA_TARGET("sse2") static int Run(const int* p, std::size_t n)
+    {
+#ifdef DEA_TEST_X86
+        __m128i acc = _mm_setzero_si128();
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            acc = _mm_add_epi32(acc,_mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(p + i)));
+        int lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes),acc);
+        return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+            SumScalar::Run(p + i,n - i);
+#else
+        return SumScalar::Run(p,n);
+#endif
+    }
+};
+
+struct SumAvx2
+{
+    enum { required = dea::CpuAvx | dea::CpuAvx2 };
+
+    DEA_TARGET("avx2") static int Run(const int* p, std::size_t n)
+    {
+#ifdef DEA_TEST_X86
+        __m256i acc = _mm256_setzero_si256();
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            acc = _mm256_add_epi32(acc,_mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(p + i)));
+        int lanes[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes),acc);
+        int sum = 0;
+        for (int lane : lanes)
+            sum += lane;
+        return sum + SumScalar::Run(p + i,n - i);
+#else
+        return SumScalar::Run(p,n);
+#endif
+    }
+};
+
+typedef dea::CpuDispatch<int(const int*,std::size_t),
+    dea::TL::MakeTypelist<SumAvx2,SumSse2,SumScalar>::Result> Sum;
+
+void Paths()
+{
+    std::vector<int> data(1003);
+    for (std::size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<int>(i * 7 % 113) - 50;
+    const int expected = SumScalar::Run(data.data(),data.size());
+
+    const unsigned int cpu = dea::CpuFeatures::Probe();
+    const struct
+    {
+        unsigned int features;
+        int selected;
+    } cases[] = {
+        { dea::CpuNone, 2 },
+        { dea::CpuSse2, 1 },
+        { dea::CpuSse2 | dea::CpuAvx | dea::CpuAvx2, 0 },
+        // AVX2 without AVX is not enough
+        { dea::CpuSse2 | dea::CpuAvx2, 1 },
+    };
+    for (const auto& c : cases)
+    {
+        dea::CpuFeatures::Override(c.features);
+        DEA_CHECK(dea::CpuFeatures::Get() == c.features);
+        Sum::Resolve();
+        DEA_CHECK(Sum::Selected() == c.selected);
+        // only run what this CPU can execute
+        if ((cpu & c.features) != c.features)
+            continue;
+        DEA_CHECK(Sum::Call(data.data(),data.size()) == expected);
+        DEA_CHECK(Sum::Call(data.data(),3) == SumScalar::Run(data.data(),3));
+    }
+
+    dea::CpuFeatures::Reset();
+    DEA_CHECK(dea::CpuFeatures::Get() == cpu);
+    Sum::Resolve();
+    DEA_CHECK(Sum::Call(data.data(),data.size()) == expected);
+}
+
+} // namespace
+
+int main()
+{
+    Paths();
+    return DEA_CHECK_RESULT;
+}
@@ -0,0 +1,156 @@
+/* {{{ LICENSE
+ * cycle.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::CycleWrap and dea::StaticCycle, including cycles over every value
+ * of their type.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "cycle.h"
+
+#include <climits>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+// }}} Includes
+
+namespace
+{
+
+void FullRange()
+{
+    dea::StaticCycle<unsigned int,0,UINT_MAX,1> u(5u);
+    ++u;
+    DEA_CHECK(u() == 6u);
+    u = UINT_MAX;
+    ++u;
+    DEA_CHECK(u() == 0u);
+    --u;
+    DEA_CHECK(u() == UINT_MAX);
+    u += 10u;
+    DEA_CHECK(u() == 9u);
+
+    dea::StaticCycle<std::uint8_t,0,255,1> b(std::uint8_t(255));
+    ++b;
+    DEA_CHECK(b() == 0);
+    b -= 3;
+    DEA_CHECK(b() == 253);
+
+    dea::StaticCycle<signed char,-128,127,1> c(static_cast<signed char>(127));
+    DEA_CHECK(c() == 127);
+    c -= 5;
+    DEA_CHECK(c() == 122);
+
+    dea::StaticCycle<unsigned int,0,UINT_MAX,1,dea::StaticCountStdOverload>
+        counted(UINT_MAX);
+    auto wraps = std::make_shared<long int>(0);
+    counted.setCounter(wraps);
+    ++counted;
+    DEA_CHECK(counted() == 0u && *wraps == 0);
+
+    typedef dea::CycleWrap<unsigned int,0,UINT_MAX> Full;
+    unsigned int t = 42u;
+    DEA_CHECK(Full::Range == 0u && Full::Wrap(t) == 0 && t == 42u);
+    DEA_CHECK(Full::Wrapped(7u) == 7u);
+}
+
+void Mask()
+{
+    typedef dea::CycleWrap<int,0,15> Wrap;
+    static_assert(Wrap::isMask && Wrap::shift == 4,"mask path");
+    int t = 35;
+    DEA_CHECK(Wrap::Wrap(t) == 2 && t == 3);
+    t = -1;
+    DEA_CHECK(Wrap::Wrap(t) == -1 && t == 15);
+    t = -17;
+    DEA_CHECK(Wrap::Wrap(t) == -2 && t == 15);
+
+    dea::StaticCycle<unsigned int,0,7,3,dea::StaticCountMaxOverload> c(6u);
+    auto wraps = std::make_shared<std::size_t>(0);
+    c.setCounter(wraps);
+    ++c;
+    ++c;
+    DEA_CHECK(c() == 4u && *wraps == 1);
+}
+
+void Division()
+{
+    typedef dea::CycleWrap<int,-3,4> Wrap;
+    static_assert(!Wrap::isMask && Wrap::Range == 8,"division path");
+    int t = 13;
+    DEA_CHECK(Wrap::Wrap(t) == 2 && t == -3);
+    t = -12;
+    DEA_CHECK(Wrap::Wrap(t) == -2 && t == 4);
+    static_assert(Wrap::Wrapped(5) == -3,"constexpr wrap");
+}
+
+// reference wrap in a wider type
+long long Reference(long long t, long long min, long long max,
+    long long& wraps)
+{
+    const long long range = max - min + 1;
+    long long q = (t - min) / range;
+    if ((t - min) % range < 0)
+        --q;
+    wraps = q;
+    return t - q * range;
+}
+
+void Extremes()
+{
+    typedef dea::CycleWrap<int,-3,4> Wrap;
+    for (int v : { INT_MIN, INT_MIN + 1, INT_MAX, INT_MAX - 1 })
+    {
+        long long wraps = 0;
+        const long long expected = Reference(v,-3,4,wraps);
+        int t = v;
+        DEA_CHECK(Wrap::Wrap(t) == wraps && t == expected);
+        DEA_CHECK(Wrap::Wrapped(v) == expected);
+    }
+    static_assert(Wrap::Wrapped(INT_MIN) == 0,"constexpr extreme");
+
+    typedef dea::CycleWrap<signed char,-100,100> Narrow;
+    for (int v : { SCHAR_MIN, SCHAR_MAX })
+    {
+        long long wraps = 0;
+        const long long expected = Reference(v,-100,100,wraps);
+        signed char t = static_cast<signed char>(v);
+        DEA_CHECK(Narrow::Wrap(t) == wraps && t == expected);
+    }
+
+    typedef dea::CycleWrap<long long,-10,LLONG_MAX-1> Wide;
+    long long w = LLONG_MAX;
+    DEA_CHECK(Wide::Wrap(w) == 1 && w == -10);
+    w = LLONG_MIN;
+    DEA_CHECK(Wide::Wrap(w) == -1 && w == 9);
+}
+
+} // namespace
+
+int main()
+{
+    FullRange();
+    Mask();
+    Division();
+    Extremes();
+    return DEA_CHECK_RESULT;
+}
@@ -0,0 +1,136 @@
+/* {{{ LICENSE
+ * cycleBatch.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::CycleBatch against stepping every dea::StaticCycle on its own.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "cycleBatch.h"
+
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <vector>
+// }}} Includes
+
+namespace
+{
+
+// Adds delta to values with CycleBatch and to a StaticCycle per value,
+// and compares the values and the wraps counted.
+template <typename Cycle, typename Counter>
+void Compare(const std::vector<typename Cycle::ValueType>& start,
+    typename Cycle::ValueType delta)
+{
+    typedef typename Cycle::ValueType T;
+    std::vector<T> values(start);
+    const long int batch =
+        dea::CycleBatch<Cycle>::Add(values.data(),values.size(),delta);
+
+    auto counter = std::make_shared<Counter>(0);
+    for (std::size_t i = 0; i < start.size(); ++i)
+    {
+        Cycle cycle(start[i]);
+        cycle.setCounter(counter);
+        cycle += delta;
+        DEA_CHECK(values[i] == cycle());
+    }
+    DEA_CHECK(batch == static_cast<long int>(*counter));
+}
+
+template <typename T>
+std::vector<T> Values(T min, T max, std::size_t n)
+{
+    std::vector<T> values(n);
+    const unsigned long long range =
+        static_cast<unsigned long long>(max) - min + 1;
+    for (std::size_t i = 0; i < n; ++i)
+        values[i] = static_cast<T>(min +
+            static_cast<T>(range ? (i * 2654435761u) % range : i * 977));
+    return values;
+}
+
+void Counting()
+{
+    typedef dea::StaticCycle<int,-5,94,1,dea::StaticCountStdOverload> Cycle;
+    const std::vector<int> values = Values(-5,94,37);
+    for (int delta : { 0, 1, 7, 99, 100, 345, -1, -100, -321 })
+        Compare<Cycle,long int>(values,delta);
+
+    typedef dea::StaticCycle<unsigned int,0,63,1,
+        dea::StaticCountStdOverload> Mask;
+    for (unsigned int delta : { 0u, 5u, 64u, 1000u })
+        Compare<Mask,long int>(Values(0u,63u,29),delta);
+}
+
+void FullRange()
+{
+    typedef dea::StaticCycle<unsigned int,0,UINT_MAX,1,
+        dea::StaticCountStdOverload> Full;
+    const std::vector<unsigned int> values = Values(0u,UINT_MAX,37);
+    for (unsigned int delta : { 0u, 1u, 0x80000000u, UINT_MAX })
+        Compare<Full,long int>(values,delta);
+
+    typedef dea::StaticCycle<std::uint8_t,0,255,1,
+        dea::StaticCountMaxOverload> Byte;
+    std::vector<std::uint8_t> bytes = Values<std::uint8_t>(0,255,19);
+    bytes.push_back(255);
+    for (int delta : { 0, 1, 200, 255 })
+        Compare<Byte,std::size_t>(bytes,static_cast<std::uint8_t>(delta));
+
+    std::vector<unsigned int> steps(9,UINT_MAX);
+    DEA_CHECK(dea::CycleBatch<Full>::Advance(steps.data(),steps.size())
+        == 0);
+    for (unsigned int v : steps)
+        DEA_CHECK(v == 0u);
+}
+
+void OnlyMax()
+{
+    typedef dea::StaticCycle<int,10,19,3,dea::StaticCountMaxOverload> Cycle;
+    typedef dea::StaticCycle<int,10,19,3> Std;
+    std::vector<int> values = Values(10,19,23);
+    const std::vector<int> start(values);
+
+    DEA_CHECK(dea::CycleBatch<Cycle>::Add(values.data(),values.size(),-7)
+        == 0);
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        Std expected(start[i]);
+        expected += -7;
+        DEA_CHECK(values[i] >= 10 && values[i] <= 19);
+        DEA_CHECK(values[i] == expected());
+    }
+
+    for (int delta : { 0, 4, 9, 10, 55 })
+        Compare<Cycle,std::size_t>(start,delta);
+}
+
+} // namespace
+
+int main()
+{
+    Counting();
+    FullRange();
+    OnlyMax();
+    return DEA_CHECK_RESULT;
+}
@@ -0,0 +1,85 @@
+/* {{{ LICENSE
+ * cycleCounter.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * The thread-safe wrap counters: cycles on many threads sharing one
+ * dea::AtomicCounter or dea::ShardedCounter count every turn exactly.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "cycle.h"
+#include "cycleCounter.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+// }}} Includes
+
+namespace
+{
+
+static_assert(sizeof(dea::AtomicCounter) >= 2 * DEA_CACHE_LINE_SIZE,
+    "the value needs a line of its own wherever it is allocated");
+static_assert(sizeof(dea::ShardedCounter<4>) == 5 * DEA_CACHE_LINE_SIZE,
+    "one line per shard and one in front");
+
+const int threads = 8;
+const int steps = 100003;
+
+// every thread steps its own cycle, all of them share the counter
+template <template <typename,int,int> class Policy, typename Counter>
+void Turns(int delta, long int expected)
+{
+    auto counter = std::make_shared<Counter>();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back([&counter,delta]()
+        {
+            dea::StaticCycle<int,0,9,1,Policy> c(0);
+            c.setCounter(counter);
+            for (int i = 0; i < steps; ++i)
+                c += delta;
+        });
+    for (std::thread& worker : workers)
+        worker.join();
+    DEA_CHECK(counter->Load() == expected);
+}
+
+} // namespace
+
+int main()
+{
+    // 100003 steps of 1 over a range of 10 wrap 10000 times per thread,
+    // steps of -3 wrap 30001 times under 0
+    Turns<dea::StaticAtomicCountStdOverload,dea::AtomicCounter>(
+        1,threads * 10000L);
+    Turns<dea::StaticAtomicCountStdOverload,dea::AtomicCounter>(
+        -3,threads * -30001L);
+    Turns<dea::StaticShardedCountStdOverload,dea::ShardedCounter<>>(
+        1,threads * 10000L);
+    Turns<dea::StaticShardedCountStdOverload,dea::ShardedCounter<>>(
+        -3,threads * -30001L);
+    Turns<dea::StaticAtomicCountMaxOverload,dea::AtomicCounter>(
+        7,threads * 70002L);
+    Turns<dea::StaticShardedCountMaxOverload,dea::ShardedCounter<>>(
+        7,threads * 70002L);
+    return DEA_CHECK_RESULT;
+}
@@ -0,0 +1,93 @@
+/* {{{ LICENSE
+ * cycleTable.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::CycleTable and dea::CycleWalk against stepping a dea::StaticCycle
+ * with operator++, at compile time where the language allows it.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "cycle.h"
+#include "cycleTable.h"
+// }}} Includes
+
+namespace
+{
+
+typedef dea::StaticCycle<int,-5,4,3> Negative;
+typedef dea::CycleTable<Negative,11> NegativeTable;
+typedef dea::StaticCycle<int,-3,3,-2> Backwards;
+typedef dea::CycleTable<Backwards,7,0> BackwardsTable;
+typedef dea::StaticCycle<unsigned int,0,15,5> Scramble;
+typedef dea::CycleTable<Scramble,17> ScrambleTable;
+
+// -5 -2 1 4 | -3 0 3 | -4 -1 2 | -5
+static_assert(NegativeTable::values[0] == -5,"start at Min");
+static_assert(NegativeTable::values[3] == 4,"reach Max");
+static_assert(NegativeTable::values[4] == -3,"wrap over Max");
+static_assert(NegativeTable::values[7] == -4,"wrap over Max");
+static_assert(NegativeTable::values[10] == -5,"back at the start");
+// 0 -2 | 3 1 -1 -3 | 2
+static_assert(BackwardsTable::values[1] == -2,"negative step");
+static_assert(BackwardsTable::values[2] == 3,"wrap under Min");
+static_assert(BackwardsTable::values[6] == 2,"wrap under Min");
+static_assert(ScrambleTable::values[16] == ScrambleTable::values[0],
+    "a step coprime to the range visits every value");
+static_assert(dea::CycleWalk<Negative>::At(-5,1000000000007ull) ==
+    NegativeTable::values[7],"large walks reduce the step count");
+
+#if __cplusplus >= 201402L
+// the mutating operators are constexpr from C++14 on
+template <typename Cycle>
+constexpr typename Cycle::ValueType Stepped(
+    typename Cycle::ValueType start, unsigned int n)
+{
+    Cycle c(start);
+    for (unsigned int i = 0; i < n; ++i)
+        ++c;
+    return c();
+}
+static_assert(Stepped<Negative>(-5,7) == NegativeTable::values[7],
+    "table matches operator++");
+static_assert(Stepped<Backwards>(0,6) == BackwardsTable::values[6],
+    "table matches operator++");
+#endif
+
+template <typename Cycle, typename Table>
+void MatchesIncrement(typename Cycle::ValueType start)
+{
+    Cycle c(start);
+    for (int i = 0; i < Table::size; ++i)
+    {
+        DEA_CHECK(Table::values[i] == c());
+        ++c;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    MatchesIncrement<Negative,NegativeTable>(-5);
+    MatchesIncrement<Backwards,BackwardsTable>(0);
+    MatchesIncrement<Scramble,ScrambleTable>(0u);
+    return DEA_CHECK_RESULT;
+}
@@ -0,0 +1,260 @@
+/* {{{ LICENSE
+ * dfa.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::Dfa against naive byte-by-byte matchers on random inputs. The
+ * automata are picked so that the pair table, the dead state and the
+ * skips with memchr, with three exit bytes and through accepting states
+ * are all taken.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "dfa.h"
+#include "typelist.h"
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+// }}} Includes
+
+namespace
+{
+
+// {{{ Automata
+// decimal numbers with an optional fraction, dies on anything else
+struct Begin; struct Int; struct Dot; struct Frac;
+typedef dea::DfaRange<'0','9'> Digit;
+typedef dea::Dfa<
+    dea::TL::MakeTypelist<Begin,Int,Dot,Frac>::Result,
+    dea::TL::MakeTypelist<Int,Frac>::Result,
+    dea::TL::MakeTypelist<
+        dea::DfaEdge<Begin,Digit,Int>,
+        dea::DfaEdge<Int,Digit,Int>,
+        dea::DfaEdge<Int,dea::DfaChars<'.'>,Dot>,
+        dea::DfaEdge<Dot,Digit,Frac>,
+        dea::DfaEdge<Frac,Digit,Frac>>::Result> Number;
+
+int NumberStep(int s, char c)
+{
+    const bool digit = c >= '0' && c <= '9';
+    switch (s)
+    {
+        case 0: return digit ? 1 : -1;
+        case 1: return digit ? 1 : c == '.' ? 2 : -1;
+        case 2: case 3: return digit ? 3 : -1;
+        default: return -1;
+    }
+}
+
+// every end of "abc", the start state skips to the next 'a'
+struct S0; struct S1; struct S2; struct S3;
+typedef dea::DfaChars<'a'> A;
+typedef dea::Dfa<
+    dea::TL::MakeTypelist<S0,S1,S2,S3>::Result,
+    dea::TL::MakeTypelist<S3>::Result,
+    dea::TL::MakeTypelist<
+        dea::DfaEdge<S0,A,S1>, dea::DfaEdge<S0,dea::DfaAny,S0>,
+        dea::DfaEdge<S1,A,S1>, dea::DfaEdge<S1,dea::DfaChars<'b'>,S2>,
+        dea::DfaEdge<S1,dea::DfaAny,S0>,
+        dea::DfaEdge<S2,A,S1>, dea::DfaEdge<S2,dea::DfaChars<'c'>,S3>,
+        dea::DfaEdge<S2,dea::DfaAny,S0>,
+        dea::DfaEdge<S3,A,S1>, dea::DfaEdge<S3,dea::DfaAny,S0>>::Result>
+    Abc;
+
+int AbcStep(int s, char c)
+{
+    if (c == 'a')
+        return 1;
+    if (s == 1 && c == 'b')
+        return 2;
+    if (s == 2 && c == 'c')
+        return 3;
+    return 0;
+}
+
+// '#' comments up to the end of the line; inside one every position
+// accepts, outside only '#', 'x' or 'y' lead anywhere else
+struct Code; struct Comment; struct Name;
+typedef dea::DfaChars<'\n'> Newline;
+typedef dea::DfaChars<'x','y'> Xy;
+typedef dea::Dfa<
+    dea::TL::MakeTypelist<Code,Comment,Name>::Result,
+    dea::TL::MakeTypelist<Comment,Name>::Result,
+    dea::TL::MakeTypelist<
+        dea::DfaEdge<Code,dea::DfaChars<'#'>,Comment>,
+        dea::DfaEdge<Code,Xy,Name>,
+        dea::DfaEdge<Code,dea::DfaChars<'!'>,Code>,
+        dea::DfaEdge<Code,dea::DfaNot<dea::DfaChars<'!'>>,Code>,
+        dea::DfaEdge<Comment,Newline,Code>,
+        dea::DfaEdge<Comment,dea::DfaAny,Comment>,
+        dea::DfaEdge<Name,Xy,Name>,
+        dea::DfaEdge<Name,Newline,Code>,
+        dea::DfaEdge<Name,dea::DfaChars<' '>,Code>>::Result> Comments;
+
+int CommentsStep(int s, char c)
+{
+    switch (s)
+    {
+        case 0:
+            return c == '#' ? 1 : c == 'x' || c == 'y' ? 2 : 0;
+        case 1: return c == '\n' ? 0 : 1;
+        case 2:
+            return c == 'x' || c == 'y' ? 2
+                : c == '\n' || c == ' ' ? 0 : -1;
+        default: return -1;
+    }
+}
+// every end of the keyword "ab...t", too many classes for the pair table
+enum { keyword = 20 };
+template <int i> struct K;
+template <int i>
+struct KeywordStates
+{
+    typedef dea::Typelist<K<i>,typename KeywordStates<i+1>::Result> Result;
+};
+template <>
+struct KeywordStates<keyword+1> { typedef dea::NullType Result; };
+template <int i>
+struct KeywordEdges
+{
+    typedef dea::Typelist<dea::DfaEdge<K<i>,dea::DfaChars<'a'+i>,K<i+1>>,
+        dea::Typelist<dea::DfaEdge<K<i>,A,K<1>>,
+        dea::Typelist<dea::DfaEdge<K<i>,dea::DfaAny,K<0>>,
+        typename KeywordEdges<i+1>::Result>>> Result;
+};
+template <>
+struct KeywordEdges<keyword>
+{
+    typedef dea::TL::MakeTypelist<dea::DfaEdge<K<keyword>,A,K<1>>,
+        dea::DfaEdge<K<keyword>,dea::DfaAny,K<0>>>::Result Result;
+};
+typedef dea::Dfa<KeywordStates<0>::Result,
+    dea::TL::MakeTypelist<K<keyword>>::Result,
+    KeywordEdges<0>::Result> Keyword;
+
+int KeywordStep(int s, char c)
+{
+    if (s < keyword && c == 'a' + s)
+        return s + 1;
+    return c == 'a' ? 1 : 0;
+}
+// }}} Automata
+
+template <typename D>
+bool Accepting(int s)
+{ return s >= 0 && D::IsAccepting(D::State(static_cast<unsigned int>(s))); }
+
+// compares everything a Dfa offers with the naive steps on `text`,
+// starting in every state
+template <typename D, typename Step>
+void Compare(const std::string& text, Step step)
+{
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+
+    for (unsigned int start = 0; start < D::states; ++start)
+    {
+        int s = static_cast<int>(start);
+        std::vector<std::size_t> expected;
+        for (std::size_t i = 0; i < text.size() && s >= 0; ++i)
+        {
+            s = step(s,text[i]);
+            if (Accepting<D>(s))
+                expected.push_back(i + 1);
+        }
+
+        DEA_CHECK(D::Index(D::Run(D::State(start),begin,end)) == s);
+
+        std::vector<std::size_t> found;
+        const typename D::StateId last = D::Scan(D::State(start),begin,end,
+            [&](const char* p) { found.push_back(p - begin); });
+        DEA_CHECK(D::Index(last) == s);
+        DEA_CHECK(found == expected);
+
+        if (start != 0)
+            continue;
+        DEA_CHECK(D::Match(begin,text.size()) == Accepting<D>(s));
+        const std::ptrdiff_t prefix = expected.empty()
+            ? (Accepting<D>(0) ? 0 : -1)
+            : static_cast<std::ptrdiff_t>(expected.back());
+        DEA_CHECK(D::Prefix(begin,text.size()) == prefix);
+    }
+}
+
+// random text over `alphabet`, with long runs of its first letter
+std::string Random(std::mt19937& random, const std::string& alphabet)
+{
+    std::string text;
+    const std::size_t size = random() % 300;
+    while (text.size() < size)
+    {
+        const char c = alphabet[random() % alphabet.size()];
+        text.append(c == alphabet[0] ? 1 + random() % 40 : 1,c);
+    }
+    return text;
+}
+
+// random prefixes of the keyword with noise in between
+std::string Prefixes(std::mt19937& random)
+{
+    const std::string word = "abcdefghijklmnopqrst";
+    std::string text;
+    const std::size_t size = random() % 300;
+    while (text.size() < size)
+    {
+        text += word.substr(0,random() % (word.size() + 1));
+        if (random() % 2)
+            text += "-a"[random() % 2];
+    }
+    return text;
+}
+
+void Examples()
+{
+    DEA_CHECK(Number::Match("12.5",4));
+    DEA_CHECK(!Number::Match("12.",3));
+    DEA_CHECK(Number::Prefix("12.x",4) == 2);
+    DEA_CHECK(Number::Prefix("x12",3) == -1);
+    const char* dies = "1x2";
+    DEA_CHECK(Number::IsDead(Number::Run(Number::Start(),dies,dies + 3)));
+    // above 4096 entries there is no pair table
+    DEA_CHECK((Keyword::states + 1) * Keyword::classes * Keyword::classes
+        > 4096);
+}
+
+} // namespace
+
+int main()
+{
+    Examples();
+    std::mt19937 random(11);
+    for (int i = 0; i < 400; ++i)
+    {
+        Compare<Number>(Random(random,"0123456789.x"),NumberStep);
+        Compare<Abc>(Random(random,"-abc"),AbcStep);
+        Compare<Abc>(Random(random,"abc"),AbcStep);
+        Compare<Comments>(Random(random," #xyz!\n"),CommentsStep);
+        Compare<Comments>(Random(random,"-#x\n"),CommentsStep);
+        Compare<Keyword>(Prefixes(random),KeywordStep);
+    }
+    return DEA_CHECK_RESULT;
+}
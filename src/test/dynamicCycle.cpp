@@ -0,0 +1,122 @@
+/* {{{ LICENSE
+ * dynamicCycle.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::DynamicCycle and dea::FastDivider against their compile-time
+ * counterparts, including cycles over every value of their type.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "cycle.h"
+#include "dynamicCycle.h"
+
+#include <climits>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+// }}} Includes
+
+namespace
+{
+
+void Divider()
+{
+    const std::uint32_t divisors[] = { 1u, 2u, 3u, 7u, 10u, 641u,
+        65535u, 0x7FFFFFFFu, 0x80000001u, UINT_MAX };
+    const std::uint32_t values[] = { 0u, 1u, 2u, 9u, 100u, 12345u,
+        0x7FFFFFFFu, 0x80000000u, UINT_MAX - 1, UINT_MAX };
+    for (std::uint32_t d : divisors)
+    {
+        const dea::FastDivider<std::uint32_t> divider(d);
+        for (std::uint32_t v : values)
+            DEA_CHECK(divider.Divide(v) == v / d);
+    }
+}
+
+void MatchesStatic()
+{
+    typedef dea::StaticCycle<int,-7,12,3,dea::StaticCountStdOverload>
+        Static;
+    auto staticWraps = std::make_shared<long int>(0);
+    auto dynamicWraps = std::make_shared<long int>(0);
+    Static s(5);
+    s.setCounter(staticWraps);
+    dea::DynamicCycle<int,dea::DynamicCountStdOverload> d(-7,12,3,5);
+    d.setCounter(dynamicWraps);
+    for (int delta : { 1, 20, 123, -1, -20, -457, 0, 39 })
+    {
+        s += delta;
+        ++s;
+        d += delta;
+        ++d;
+        DEA_CHECK(s() == d());
+    }
+    DEA_CHECK(*staticWraps == *dynamicWraps);
+}
+
+void FullRange()
+{
+    dea::DynamicCycle<unsigned int,dea::DynamicCountStdOverload>
+        u(0u,UINT_MAX,1u,5u);
+    auto wraps = std::make_shared<long int>(0);
+    u.setCounter(wraps);
+    ++u;
+    DEA_CHECK(u() == 6u);
+    u = UINT_MAX;
+    ++u;
+    DEA_CHECK(u() == 0u && *wraps == 0);
+
+    const dea::DynamicCycleWrap<std::uint8_t> byte(0,255);
+    std::uint8_t b = 200;
+    DEA_CHECK(byte.Range() == 0 && byte.Wrap(b) == 0 && b == 200);
+
+    const dea::DynamicCycleWrap<std::int64_t> wide(
+        std::numeric_limits<std::int64_t>::min(),
+        std::numeric_limits<std::int64_t>::max());
+    std::int64_t w = -42;
+    DEA_CHECK(wide.Range() == 0 && wide.Wrap(w) == 0 && w == -42);
+}
+
+void Invalid()
+{
+    bool thrown = false;
+    try
+    {
+        dea::DynamicCycle<int> c(5,4);
+    }
+    catch (const std::invalid_argument&)
+    {
+        thrown = true;
+    }
+    DEA_CHECK(thrown);
+}
+
+} // namespace
+
+int main()
+{
+    Divider();
+    MatchesStatic();
+    FullRange();
+    Invalid();
+    return DEA_CHECK_RESULT;
+}
@@ -0,0 +1,161 @@
+/* {{{ LICENSE
+ * eventBus.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::EventBus: handlers that publish, post, subscribe and unsubscribe
+ * while they are called, and the order in which Flush delivers posted
+ * events.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "eventBus.h"
+#include "typelist.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+// }}} Includes
+
+namespace
+{
+
+struct Key
+{
+    char code;
+};
+
+struct Hit
+{
+    int a;
+    int b;
+};
+
+typedef dea::EventBus<dea::TL::MakeTypelist<Key,Hit>::Result> Bus;
+
+void Reentrant()
+{
+    Bus bus;
+    std::string log;
+    std::size_t late = 0;
+
+    // a key publishes a hit, a hit of 0 publishes another key
+    bus.Subscribe<Key>([&](const Key& k)
+    {
+        log += k.code;
+        bus.Publish(Hit{k.code == 'a' ? 0 : 1,0});
+    });
+    bus.Subscribe<Hit>([&](const Hit& h)
+    {
+        log += static_cast<char>('0' + h.a);
+        if (h.a == 0)
+            bus.Publish(Key{'b'});
+    });
+    // subscribes during a delivery: called from the next event on
+    const std::size_t once = bus.Subscribe<Key>([&](const Key&)
+    {
+        log += '!';
+        if (late == 0)
+            late = bus.Subscribe<Key>([&](const Key&) { log += '+'; });
+    });
+
+    bus.Publish(Key{'a'});
+    // a 0 b 1 ! (the nested key) then ! of the outer key; '+' was added
+    // during the delivery and sees the nested key neither
+    DEA_CHECK(log == "a0b1!!");
+
+    log.clear();
+    DEA_CHECK(bus.Unsubscribe<Key>(once));
+    DEA_CHECK(!bus.Unsubscribe<Key>(once));
+    bus.Publish(Key{'c'});
+    DEA_CHECK(log == "c1+");
+
+    // a handler removing itself and another one mid-delivery
+    log.clear();
+    Bus other;
+    std::size_t self = 0;
+    std::size_t next = 0;
+    self = other.Subscribe<Key>([&](const Key&)
+    {
+        log += 's';
+        other.Unsubscribe<Key>(self);
+        other.Unsubscribe<Key>(next);
+    });
+    next = other.Subscribe<Key>([&](const Key&) { log += 'n'; });
+    other.Publish(Key{'x'});
+    other.Publish(Key{'y'});
+    DEA_CHECK(log == "s");
+}
+
+void FlushOrder()
+{
+    Bus bus;
+    std::string log;
+    std::vector<std::size_t> batches;
+
+    bus.Subscribe<Key>([&](const Key& k)
+    {
+        log += k.code;
+        // posted meanwhile: waits for the next flush
+        if (k.code == 'q')
+            bus.Post<Key>(Key{'r'});
+        // nested flushes do nothing
+        bus.Flush();
+    });
+    bus.Subscribe<Hit>([&](const Hit& h)
+    {
+        log += static_cast<char>('0' + h.a + h.b);
+        // a key posted from a hit is flushed next time too
+        if (h.a == 1)
+            bus.Post<Key>(Key{'z'});
+    });
+    bus.SubscribeBatch<Hit>([&](const Hit* hits, std::size_t n)
+    {
+        batches.push_back(n);
+        DEA_CHECK(n == 0 || hits != nullptr);
+    });
+
+    // posted hits before keys, flushed keys first: typelist order
+    bus.Post<Hit>(Hit{1,2});
+    bus.Post<Hit>(Hit{4,0});
+    bus.Post<Key>(Key{'p'});
+    bus.Post<Key>(Key{'q'});
+    DEA_CHECK(bus.Channel<Key>().Pending() == 2);
+    bus.Flush();
+    DEA_CHECK(log == "pq34");
+    DEA_CHECK(batches == std::vector<std::size_t>{2});
+    DEA_CHECK(bus.Channel<Key>().Pending() == 2);
+
+    log.clear();
+    bus.Flush();
+    DEA_CHECK(log == "rz");
+    DEA_CHECK(bus.Channel<Key>().Pending() == 0);
+    bus.Flush();
+    DEA_CHECK(log == "rz" && batches.size() == 1);
+}
+
+} // namespace
+
+int main()
+{
+    Reentrant();
+    FlushOrder();
+    return DEA_CHECK_RESULT;
+}
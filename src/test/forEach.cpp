@@ -0,0 +1,150 @@
+/* {{{ LICENSE
+ * forEach.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::TL::ForEach and dea::ForEachField, in order on the calling
+ * thread and as tasks on a dea::ThreadPool, including nested groups and
+ * exceptions thrown by a call.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "forEach.h"
+#include "hierarchy.h"
+#include "threadPool.h"
+#include "typelist.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// }}} Includes
+
+namespace
+{
+
+typedef dea::TL::MakeTypelist<char,int,double,std::string>::Result Types;
+
+struct Sizes
+{
+    std::vector<std::size_t>& sizes;
+
+    template <typename T>
+    void operator()(dea::Type2Type<T>) const { sizes.push_back(sizeof(T)); }
+};
+
+// every type bumps its own counter, by its index in the list
+struct Count
+{
+    std::atomic<int>* counts;
+
+    template <typename T>
+    void operator()(dea::Type2Type<T>) const
+    { ++counts[dea::TL::IndexOf<Types,T>::value]; }
+};
+
+struct Twice
+{
+    void operator()(char& c) const { c = static_cast<char>(c + 1); }
+    void operator()(int& i) const { i *= 2; }
+    void operator()(double& d) const { d *= 2; }
+    void operator()(std::string& s) const { s += s; }
+};
+
+struct Throws
+{
+    template <typename T>
+    void operator()(dea::Type2Type<T>) const
+    {
+        if (dea::TL::IndexOf<Types,T>::value == 2)
+            throw std::runtime_error("double");
+    }
+};
+
+void Sequential()
+{
+    std::vector<std::size_t> sizes;
+    dea::TL::ForEach<Types>::Do(Sizes{sizes});
+    const std::vector<std::size_t> expected = { sizeof(char), sizeof(int),
+        sizeof(double), sizeof(std::string) };
+    DEA_CHECK(sizes == expected);
+
+    dea::Tuple<Types> tuple;
+    dea::Field<0>(tuple) = 'a';
+    dea::Field<1>(tuple) = 21;
+    dea::Field<2>(tuple) = 0.25;
+    dea::Field<3>(tuple) = "ab";
+    dea::ForEachField(tuple,Twice());
+    DEA_CHECK(dea::Field<0>(tuple) == 'b' && dea::Field<1>(tuple) == 42 &&
+        dea::Field<2>(tuple) == 0.5 && dea::Field<3>(tuple) == "abab");
+}
+
+void Parallel()
+{
+    dea::ThreadPool pool(4);
+
+    for (int round = 0; round < 200; ++round)
+    {
+        std::atomic<int> counts[4] = {};
+        dea::TL::ForEach<Types>::Parallel(pool,Count{counts});
+        for (const std::atomic<int>& count : counts)
+            DEA_CHECK(count.load() == 1);
+    }
+
+    // groups nested in tasks wait by running other tasks
+    std::atomic<int> counts[4] = {};
+    dea::TaskGroup outer(pool);
+    for (int i = 0; i < 16; ++i)
+        outer.Run([&pool,&counts]
+        { dea::TL::ForEach<Types>::Parallel(pool,Count{counts}); });
+    outer.Wait();
+    for (const std::atomic<int>& count : counts)
+        DEA_CHECK(count.load() == 16);
+
+    dea::Tuple<Types> tuple;
+    dea::Field<0>(tuple) = 'a';
+    dea::Field<1>(tuple) = 21;
+    dea::Field<2>(tuple) = 0.25;
+    dea::Field<3>(tuple) = "ab";
+    dea::Tuple<Types> sequential = tuple;
+    dea::ForEachField(pool,tuple,Twice());
+    dea::ForEachField(sequential,Twice());
+    DEA_CHECK(tuple == sequential);
+
+    bool thrown = false;
+    try
+    {
+        dea::TL::ForEach<Types>::Parallel(pool,Throws());
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    DEA_CHECK(thrown);
+}
+
+} // namespace
+
+int main()
+{
+    Sequential();
+    Parallel();
+    return DEA_CHECK_RESULT;
+}
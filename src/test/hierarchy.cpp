@@ -0,0 +1,112 @@
+/* {{{ LICENSE
+ * hierarchy.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::GenScatterHierarchy, dea::Tuple and dea::Field, including
+ * typelists that hold a type more than once and const tuples.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "hierarchy.h"
+#include "typelist.h"
+
+#include <string>
+#include <type_traits>
+// }}} Includes
+
+namespace
+{
+
+template <typename T>
+struct Holder
+{
+    T value_;
+};
+
+void DuplicateTypes()
+{
+    typedef dea::Tuple<dea::TL::MakeTypelist<int,int,std::string,int>
+        ::Result> Record;
+    Record record;
+    dea::Field<0>(record) = 1;
+    dea::Field<1>(record) = 2;
+    dea::Field<2>(record) = "three";
+    dea::Field<3>(record) = 4;
+    DEA_CHECK(dea::Field<0>(record) == 1);
+    DEA_CHECK(dea::Field<1>(record) == 2);
+    DEA_CHECK(dea::Field<2>(record) == "three");
+    DEA_CHECK(dea::Field<3>(record) == 4);
+
+    typedef dea::GenScatterHierarchy<dea::TL::MakeTypelist<
+        std::string,double,std::string>::Result,Holder> Info;
+    Info info;
+    dea::Field<0>(info).value_ = "left";
+    dea::Field<2>(info).value_ = "right";
+    DEA_CHECK(dea::Field<0>(info).value_ == "left");
+    DEA_CHECK(dea::Field<2>(info).value_ == "right");
+    DEA_CHECK(&dea::Field<0>(info) != &dea::Field<2>(info));
+}
+
+void ConstFields()
+{
+    typedef dea::Tuple<dea::TL::MakeTypelist<int,double,int>::Result>
+        Record;
+    Record record;
+    dea::Field<0>(record) = 7;
+    dea::Field<1>(record) = 0.5;
+    dea::Field<2>(record) = 9;
+
+    const Record& view = record;
+    static_assert(std::is_same<decltype(dea::Field<1>(view)),
+        const double&>::value,"Field<i> on a const tuple is const");
+    DEA_CHECK(dea::Field<0>(view) == 7);
+    DEA_CHECK(dea::Field<1>(view) == 0.5);
+    DEA_CHECK(dea::Field<2>(view) == 9);
+
+    // Field<0> refers to the field itself, not to a copy
+    DEA_CHECK(&dea::Field<0>(view) == &dea::Field<0>(record));
+    dea::Field<0>(record) = 8;
+    DEA_CHECK(dea::Field<0>(view) == 8);
+}
+
+void Comparison()
+{
+    typedef dea::Tuple<dea::TL::MakeTypelist<int,std::string>::Result>
+        Record;
+    Record a, b;
+    dea::Field<0>(a) = 1;
+    dea::Field<1>(a) = "x";
+    dea::Field<0>(b) = 1;
+    dea::Field<1>(b) = "x";
+    DEA_CHECK(a == b && !(a != b));
+    dea::Field<1>(b) = "y";
+    DEA_CHECK(a != b && !(a == b));
+}
+
+} // namespace
+
+int main()
+{
+    DuplicateTypes();
+    ConstFields();
+    Comparison();
+    return DEA_CHECK_RESULT;
+}
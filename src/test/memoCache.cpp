@@ -0,0 +1,173 @@
+/* {{{ LICENSE
+ * memoCache.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::MemoCache against a reference LRU list, with a hash that piles
+ * keys into clusters wrapping around the end of the table so Erase has
+ * to shift entries back, and the field-wise dea::Hash of a dea::Tuple.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "hierarchy.h"
+#include "memoCache.h"
+#include "tupleHash.h"
+#include "typelist.h"
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <new>
+#include <random>
+#include <string>
+// }}} Includes
+
+namespace
+{
+
+typedef dea::TL::MakeTypelist<int,std::string>::Result Args;
+typedef dea::Tuple<Args> Key;
+
+Key MakeKey(int i)
+{
+    Key key;
+    dea::Field<0>(key) = i;
+    dea::Field<1>(key) = std::to_string(i * 7);
+    return key;
+}
+
+// 8 entries live in 16 slots, every key lands on slots 14,15,0,1,2
+struct Clustered
+{
+    std::size_t operator()(const Key& key) const
+    { return 14 + static_cast<std::size_t>(dea::Field<0>(key)) % 5; }
+};
+
+void Eviction()
+{
+    dea::MemoCache<Args,int> cache(3);
+    cache.Insert(MakeKey(1),10);
+    cache.Insert(MakeKey(2),20);
+    cache.Insert(MakeKey(3),30);
+    DEA_CHECK(cache.Find(MakeKey(1)) && *cache.Find(MakeKey(1)) == 10);
+    // 2 is the least recently used now
+    cache.Insert(MakeKey(4),40);
+    DEA_CHECK(cache.Size() == 3);
+    DEA_CHECK(cache.Find(MakeKey(2)) == nullptr);
+    DEA_CHECK(cache.Find(MakeKey(1)) && cache.Find(MakeKey(3)) &&
+        cache.Find(MakeKey(4)));
+
+    int computed = 0;
+    auto compute = [&computed](const Key& k)
+    { ++computed; return dea::Field<0>(k) * 10; };
+    DEA_CHECK(cache.Get(MakeKey(4),compute) == 40 && computed == 0);
+    DEA_CHECK(cache.Get(MakeKey(5),compute) == 50 && computed == 1);
+    // 1 was evicted by 5, 3 and 4 were used since
+    DEA_CHECK(cache.Find(MakeKey(1)) == nullptr);
+    DEA_CHECK(cache.Erase(MakeKey(3)) && !cache.Erase(MakeKey(3)));
+    DEA_CHECK(cache.Size() == 2);
+    cache.Clear();
+    DEA_CHECK(cache.Size() == 0 && cache.Find(MakeKey(4)) == nullptr);
+}
+
+// random operations against a most-recent-first list of keys
+void Reference()
+{
+    dea::MemoCache<Args,int,Clustered> cache(8);
+    std::list<int> lru;
+    std::mt19937 random(5);
+
+    auto touch = [&lru](int k)
+    {
+        lru.remove(k);
+        lru.push_front(k);
+    };
+
+    for (int step = 0; step < 20000; ++step)
+    {
+        const int k = static_cast<int>(random() % 24);
+        const bool cached = std::find(lru.begin(),lru.end(),k) != lru.end();
+        switch (random() % 3)
+        {
+            case 0:
+            {
+                int* value = cache.Find(MakeKey(k));
+                DEA_CHECK((value != nullptr) == cached);
+                if (value)
+                {
+                    DEA_CHECK(*value == k + 1000);
+                    touch(k);
+                }
+                break;
+            }
+            case 1:
+                cache.Insert(MakeKey(k),k + 1000);
+                if (!cached && lru.size() == 8)
+                    lru.pop_back();
+                touch(k);
+                break;
+            default:
+                DEA_CHECK(cache.Erase(MakeKey(k)) == cached);
+                lru.remove(k);
+        }
+        DEA_CHECK(cache.Size() == lru.size());
+    }
+    // every entry is still reachable after all the shifting
+    const std::list<int> left = lru;
+    for (int k : left)
+        DEA_CHECK(cache.Find(MakeKey(k)) != nullptr);
+}
+
+void TupleHash()
+{
+    typedef dea::TL::MakeTypelist<char,int,double,std::string>::Result
+        Mixed;
+    typedef dea::Tuple<Mixed> Record;
+    const dea::Hash<Record> hash;
+
+    // equal tuples hash equally whatever their padding holds
+    alignas(Record) char dirty[sizeof(Record)];
+    std::memset(dirty,0xAB,sizeof(dirty));
+    Record* a = new (dirty) Record;
+    Record b;
+    dea::Field<0>(*a) = dea::Field<0>(b) = 'x';
+    dea::Field<1>(*a) = dea::Field<1>(b) = 42;
+    dea::Field<2>(*a) = 0.0;
+    dea::Field<2>(b) = -0.0;
+    dea::Field<3>(*a) = dea::Field<3>(b) = "key";
+    DEA_CHECK(*a == b && hash(*a) == hash(b));
+
+    dea::Field<1>(b) = 43;
+    DEA_CHECK(hash(*a) != hash(b));
+    dea::Field<1>(b) = 42;
+    dea::Field<3>(b) = "kez";
+    DEA_CHECK(hash(*a) != hash(b));
+    a->~Record();
+}
+
+} // namespace
+
+int main()
+{
+    Eviction();
+    Reference();
+    TupleHash();
+    return DEA_CHECK_RESULT;
+}
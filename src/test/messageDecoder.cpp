@@ -0,0 +1,210 @@
+/* {{{ LICENSE
+ * messageDecoder.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::MessageDecoder: a stream of encoded messages decodes to the same
+ * messages however it is split across Feed calls, also with frames and
+ * tags cut in half.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "messageDecoder.h"
+#include "typelist.h"
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <vector>
+// }}} Includes
+
+namespace
+{
+
+struct Ping
+{
+    std::uint8_t id;
+};
+
+struct Order
+{
+    std::uint32_t quantity;
+    double price;
+};
+
+struct Note
+{
+    char text[13];
+};
+
+typedef dea::TL::MakeTypelist<Ping,Order,Note>::Result Messages;
+
+// what a handler saw: the tag and a checksum of the payload
+struct Seen
+{
+    int tag;
+    std::uint64_t value;
+
+    bool operator==(const Seen& other) const
+    { return tag == other.tag && value == other.value; }
+};
+
+struct Recorder
+{
+    std::vector<Seen> seen;
+
+    void operator()(dea::MessageView<Ping> ping)
+    { seen.push_back(Seen{0,ping.Load().id}); }
+    void operator()(dea::MessageView<Order> order)
+    {
+        const Order o = order.Load();
+        seen.push_back(Seen{1,o.quantity +
+            static_cast<std::uint64_t>(o.price * 4)});
+    }
+    void operator()(dea::MessageView<Note> note)
+    {
+        std::uint64_t sum = 0;
+        for (char c : note.Load().text)
+            sum = sum * 31 + static_cast<unsigned char>(c);
+        seen.push_back(Seen{2,sum});
+    }
+};
+
+// encodes n random messages, returns what a Recorder has to see
+template <typename Decoder>
+std::vector<Seen> Stream(int n, std::vector<char>& bytes)
+{
+    std::mt19937 random(n);
+    Recorder expected;
+    char frame[Decoder::maxFrameSize];
+    for (int i = 0; i < n; ++i)
+    {
+        std::size_t size = 0;
+        switch (random() % 3)
+        {
+            case 0:
+            {
+                const Ping ping{static_cast<std::uint8_t>(random())};
+                size = Decoder::Encode(ping,frame);
+                expected(dea::MessageView<Ping>(frame + Decoder::tagSize));
+                break;
+            }
+            case 1:
+            {
+                const Order order{
+                    static_cast<std::uint32_t>(random() % 1000),
+                    (random() % 400) * 0.25};
+                size = Decoder::Encode(order,frame);
+                expected(dea::MessageView<Order>(frame + Decoder::tagSize));
+                break;
+            }
+            default:
+            {
+                Note note;
+                for (char& c : note.text)
+                    c = static_cast<char>('a' + random() % 26);
+                size = Decoder::Encode(note,frame);
+                expected(dea::MessageView<Note>(frame + Decoder::tagSize));
+            }
+        }
+        bytes.insert(bytes.end(),frame,frame + size);
+    }
+    return expected.seen;
+}
+
+template <typename Decoder>
+void Splits()
+{
+    std::vector<char> bytes;
+    const std::vector<Seen> expected = Stream<Decoder>(200,bytes);
+
+    // in one piece
+    {
+        Decoder decoder;
+        Recorder recorder;
+        DEA_CHECK(decoder.Feed(bytes.data(),bytes.size(),recorder) == 200);
+        DEA_CHECK(recorder.seen == expected && decoder.Pending() == 0);
+    }
+    // split in two at every byte of the first few frames
+    for (std::size_t cut = 0; cut < 4 * Decoder::maxFrameSize; ++cut)
+    {
+        Decoder decoder;
+        Recorder recorder;
+        std::size_t decoded = decoder.Feed(bytes.data(),cut,recorder);
+        decoded += decoder.Feed(bytes.data() + cut,bytes.size() - cut,
+            recorder);
+        DEA_CHECK(decoded == 200);
+        DEA_CHECK(recorder.seen == expected && decoder.Pending() == 0);
+    }
+    // byte by byte, and in random pieces
+    for (unsigned int seed = 0; seed < 20; ++seed)
+    {
+        std::mt19937 random(seed);
+        Decoder decoder;
+        Recorder recorder;
+        std::size_t at = 0;
+        while (at < bytes.size())
+        {
+            std::size_t piece = seed == 0 ? 1 : random() % 40;
+            if (piece > bytes.size() - at)
+                piece = bytes.size() - at;
+            decoder.Feed(bytes.data() + at,piece,recorder);
+            at += piece;
+        }
+        DEA_CHECK(recorder.seen == expected && decoder.Pending() == 0);
+    }
+}
+
+void UnknownTag()
+{
+    typedef dea::MessageDecoder<Messages> Decoder;
+    Decoder decoder;
+    Recorder recorder;
+    char bytes[Decoder::maxFrameSize];
+    Decoder::Encode(Ping{7},bytes);
+    decoder.Feed(bytes,1,recorder);
+    DEA_CHECK(decoder.Pending() == 1);
+    // completes the Ping, then is read as a tag
+    const char bad = 3;
+    bool thrown = false;
+    try
+    {
+        decoder.Feed(&bad,1,recorder);
+        decoder.Feed(&bad,1,recorder);
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    DEA_CHECK(thrown && decoder.Pending() == 0);
+    DEA_CHECK(recorder.seen.size() == 1);
+}
+
+} // namespace
+
+int main()
+{
+    Splits<dea::MessageDecoder<Messages>>();
+    // a two byte tag can be cut in half as well
+    Splits<dea::MessageDecoder<Messages,std::uint16_t>>();
+    UnknownTag();
+    return DEA_CHECK_RESULT;
+}
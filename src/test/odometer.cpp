@@ -0,0 +1,113 @@
+/* {{{ LICENSE
+ * odometer.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::Odometer: Advance against repeated Increment on mixed digits,
+ * and Index and Set on a counting odometer.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "cycle.h"
+#include "odometer.h"
+#include "typelist.h"
+
+#include <initializer_list>
+// }}} Includes
+
+namespace
+{
+
+// negative Min, a Step other than 1 and an offset Min
+typedef dea::Odometer<typename dea::TL::MakeTypelist<
+    dea::StaticCycle<int,-2,2,1>,
+    dea::StaticCycle<unsigned int,0,6,3>,
+    dea::StaticCycle<int,10,13,1>>::Result> Mixed;
+
+typedef dea::Odometer<typename dea::TL::MakeTypelist<
+    dea::StaticCycle<int,0,59,1>,
+    dea::StaticCycle<int,0,59,1>,
+    dea::StaticCycle<int,0,23,1>>::Result> Clock;
+
+static_assert(Mixed::cardinality == 5 * 7 * 4,"product of the radices");
+static_assert(Clock::cardinality == 86400,"seconds per day");
+
+bool Same(const Mixed& a, const Mixed& b)
+{
+    return a.Get<0>() == b.Get<0>() && a.Get<1>() == b.Get<1>() &&
+        a.Get<2>() == b.Get<2>() && a.Index() == b.Index();
+}
+
+void AdvanceMatchesIncrement()
+{
+    Mixed stepped;
+    Mixed jumped;
+    unsigned long long wraps = 0;
+    for (unsigned long long n : { 0ull, 1ull, 4ull, 5ull, 6ull, 34ull,
+            35ull, 139ull, 140ull, 141ull, 1000ull, 12345ull })
+    {
+        unsigned long long counted = 0;
+        for (unsigned long long i = 0; i < n; ++i)
+            counted += stepped.Increment();
+        DEA_CHECK(jumped.Advance(n) == counted);
+        DEA_CHECK(Same(stepped,jumped));
+        wraps += counted;
+    }
+    // the Step 3 digit carries 3 times in its 7 steps
+    DEA_CHECK(Mixed(5 * 7).Get<2>() == 10 + 3);
+    DEA_CHECK(Mixed(140 * 7).Index() == 0);
+
+    Mixed huge;
+    huge.Advance(~0ull);
+    Mixed reference;
+    reference.Advance(~0ull % (Mixed::cardinality * 3));
+    DEA_CHECK(Same(huge,reference));
+    DEA_CHECK(wraps > 0);
+}
+
+void IndexAndSet()
+{
+    Clock clock(3725);
+    DEA_CHECK(clock.Get<0>() == 5 && clock.Get<1>() == 2 &&
+        clock.Get<2>() == 1);
+    DEA_CHECK(clock.Index() == 3725);
+
+    for (unsigned long long steps : { 0ull, 59ull, 60ull, 3599ull,
+            86399ull, 86400ull, 86401ull, 1000000ull })
+    {
+        clock.Set(steps);
+        DEA_CHECK(clock.Index() == steps % Clock::cardinality);
+    }
+
+    clock.Set(86399);
+    DEA_CHECK(clock.Increment());
+    DEA_CHECK(clock.Index() == 0);
+    ++clock;
+    DEA_CHECK(clock.Index() == 1);
+}
+
+} // namespace
+
+int main()
+{
+    AdvanceMatchesIncrement();
+    IndexAndSet();
+    return DEA_CHECK_RESULT;
+}
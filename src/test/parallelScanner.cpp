@@ -0,0 +1,158 @@
+/* {{{ LICENSE
+ * parallelScanner.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::ParallelScanner against dea::Dfa::Run and dea::Dfa::Scan on random
+ * inputs. Chunks of a few bytes and lookbacks down to zero make most
+ * chunks guess their start state from several candidates, rescan after
+ * a wrong guess and, for an automaton whose states never merge, run all
+ * candidates to the end of the chunk.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "dfa.h"
+#include "parallelScanner.h"
+#include "threadPool.h"
+#include "typelist.h"
+
+#include <cstddef>
+#include <initializer_list>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// }}} Includes
+
+namespace
+{
+
+// {{{ Automata
+// decimal numbers, dies on the first byte that does not fit
+struct Begin; struct Int; struct Dot; struct Frac;
+typedef dea::DfaRange<'0','9'> Digit;
+typedef dea::Dfa<
+    dea::TL::MakeTypelist<Begin,Int,Dot,Frac>::Result,
+    dea::TL::MakeTypelist<Int,Frac>::Result,
+    dea::TL::MakeTypelist<
+        dea::DfaEdge<Begin,Digit,Int>,
+        dea::DfaEdge<Int,Digit,Int>,
+        dea::DfaEdge<Int,dea::DfaChars<'.'>,Dot>,
+        dea::DfaEdge<Dot,Digit,Frac>,
+        dea::DfaEdge<Frac,Digit,Frac>>::Result> Number;
+
+// every end of "abc", synchronizes after any byte but 'a', 'b' or 'c'
+struct S0; struct S1; struct S2; struct S3;
+typedef dea::DfaChars<'a'> A;
+typedef dea::Dfa<
+    dea::TL::MakeTypelist<S0,S1,S2,S3>::Result,
+    dea::TL::MakeTypelist<S3>::Result,
+    dea::TL::MakeTypelist<
+        dea::DfaEdge<S0,A,S1>, dea::DfaEdge<S0,dea::DfaAny,S0>,
+        dea::DfaEdge<S1,A,S1>, dea::DfaEdge<S1,dea::DfaChars<'b'>,S2>,
+        dea::DfaEdge<S1,dea::DfaAny,S0>,
+        dea::DfaEdge<S2,A,S1>, dea::DfaEdge<S2,dea::DfaChars<'c'>,S3>,
+        dea::DfaEdge<S2,dea::DfaAny,S0>,
+        dea::DfaEdge<S3,A,S1>, dea::DfaEdge<S3,dea::DfaAny,S0>>::Result>
+    Abc;
+
+// number of 'a's modulo 3, states never merge
+struct M0; struct M1; struct M2;
+typedef dea::Dfa<
+    dea::TL::MakeTypelist<M0,M1,M2>::Result,
+    dea::TL::MakeTypelist<M0>::Result,
+    dea::TL::MakeTypelist<
+        dea::DfaEdge<M0,A,M1>, dea::DfaEdge<M0,dea::DfaAny,M0>,
+        dea::DfaEdge<M1,A,M2>, dea::DfaEdge<M1,dea::DfaAny,M1>,
+        dea::DfaEdge<M2,A,M0>, dea::DfaEdge<M2,dea::DfaAny,M2>>::Result>
+    Mod3;
+// }}} Automata
+
+// compares the scanner with the automaton on `text`, from every state
+template <typename D>
+void Compare(dea::ParallelScanner<D>& scanner, const std::string& text)
+{
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    for (unsigned int i = 0; i < D::states; ++i)
+    {
+        const typename D::StateId start = D::State(i);
+        std::vector<const char*> expected;
+        const typename D::StateId last = D::Scan(start,begin,end,
+            [&](const char* p) { expected.push_back(p); });
+
+        DEA_CHECK(scanner.Run(start,begin,end) == last);
+        DEA_CHECK(scanner.Count(start,begin,end) == expected.size());
+        std::vector<const char*> found;
+        DEA_CHECK(scanner.Scan(start,begin,end,
+            [&](const char* p) { found.push_back(p); }) == last);
+        DEA_CHECK(found == expected);
+    }
+}
+
+std::string Random(std::mt19937& random, const std::string& alphabet)
+{
+    std::string text(random() % 100,' ');
+    for (char& c : text)
+        c = alphabet[random() % alphabet.size()];
+    return text;
+}
+
+template <typename D>
+void Chunks(dea::ThreadPool& pool, const std::string& alphabet)
+{
+    std::mt19937 random(17);
+    for (std::size_t chunkSize : {1,3,8,64})
+        for (std::size_t lookback : {0,1,4,256})
+        {
+            dea::ParallelScanner<D> scanner(pool,chunkSize,lookback);
+            Compare(scanner,std::string());
+            for (int i = 0; i < 10; ++i)
+                Compare(scanner,Random(random,alphabet));
+        }
+}
+
+void ZeroChunk(dea::ThreadPool& pool)
+{
+    bool thrown = false;
+    try
+    {
+        dea::ParallelScanner<Abc> scanner(pool,0);
+    }
+    catch (const std::invalid_argument&)
+    {
+        thrown = true;
+    }
+    DEA_CHECK(thrown);
+}
+
+} // namespace
+
+int main()
+{
+    dea::ThreadPool pool(3);
+    ZeroChunk(pool);
+    Chunks<Number>(pool,"0123456789.");
+    Chunks<Number>(pool,"01.x");
+    Chunks<Abc>(pool,"abc");
+    Chunks<Abc>(pool,"abc-");
+    Chunks<Mod3>(pool,"a-");
+    return DEA_CHECK_RESULT;
+}
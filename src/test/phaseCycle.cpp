@@ -0,0 +1,105 @@
+/* {{{ LICENSE
+ * phaseCycle.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::PhaseCycle: turn counting in both directions and the conversion
+ * between turns and the fixed-point phase.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "phaseCycle.h"
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+// }}} Includes
+
+namespace
+{
+
+typedef dea::PhaseCycle<std::uint32_t> Phase32;
+typedef dea::PhaseCycle<std::uint8_t> Phase8;
+
+static_assert(Phase32::FromTurns(0.25) == 0x40000000u,"quarter turn");
+static_assert(Phase32::FromTurns(-0.25) == 0xC0000000u,"negative turns");
+static_assert(Phase32::FromTurns(3.5) == 0x80000000u,"whole turns drop");
+static_assert(Phase8::FromTurns(0.5) == 128,"narrow phase");
+
+void Turns()
+{
+    dea::PhaseCycle<std::uint32_t,dea::PhaseCountOverload> p(0.0,0.25);
+    auto turns = std::make_shared<long int>(0);
+    p.setCounter(turns);
+
+    for (int i = 0; i < 8; ++i)
+        ++p;
+    DEA_CHECK(p() == 0u && *turns == 2);
+
+    --p;
+    DEA_CHECK(p.Double() == 0.75 && *turns == 1);
+
+    // 1.75 + 2.5 = 4.25
+    p += 2.5;
+    DEA_CHECK(p.Double() == 0.25 && *turns == 4);
+    // 4.25 - 0.75 = 3.5
+    p -= 0.75;
+    DEA_CHECK(p.Double() == 0.5 && *turns == 3);
+    // 3.5 - 4.0 = -0.5
+    p -= 4.0;
+    DEA_CHECK(p.Double() == 0.5 && *turns == -1);
+
+    p.setStep(1.0 / 3.0);
+    p.setRaw(0u);
+    for (int i = 0; i < 3000; ++i)
+        p++;
+    // the truncated step loses a little each time, 999 full turns
+    DEA_CHECK(*turns == -1 + 999);
+}
+
+void RoundTrip()
+{
+    for (double t : { 0.0, 0.125, 0.5, 0.75, 0.9990234375 })
+    {
+        const Phase32 p(t);
+        DEA_CHECK(p.Double() == t);
+        DEA_CHECK(p.Float() == static_cast<float>(t));
+        DEA_CHECK(Phase32::FromTurns(t + 5.0) == p());
+        DEA_CHECK(Phase32::FromTurns(t - 5.0) == p());
+    }
+
+    // a fraction below the resolution just under 0 must not become 1.0
+    DEA_CHECK(Phase32::FromTurns(-1e-300) == 0u);
+
+    const Phase8 b(0.75);
+    DEA_CHECK(b() == 192 && b.Index<2>() == 3 && b.Index<8>() == 192);
+    const Phase32 q(0.3);
+    DEA_CHECK(q.Index<10>() ==
+        static_cast<std::uint32_t>(0.3 * 1024));
+}
+
+} // namespace
+
+int main()
+{
+    Turns();
+    RoundTrip();
+    return DEA_CHECK_RESULT;
+}
@@ -0,0 +1,168 @@
+/* {{{ LICENSE
+ * pipeline.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::Pipeline: the same stages give the same output inline and on
+ * threads, with queues small enough to fill up, stages that fall asleep
+ * between pushes, and a stage that throws.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "pipeline.h"
+#include "typelist.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+// }}} Includes
+
+namespace
+{
+
+// transforms
+struct Scale
+{
+    typedef int Input;
+    std::size_t seen = 0;
+
+    template <typename Emit>
+    void operator()(int&& x, const Emit& emit)
+    {
+        ++seen;
+        emit(static_cast<long>(x) * 3);
+    }
+};
+
+// filters
+struct DropFives
+{
+    typedef long Input;
+
+    template <typename Emit>
+    void operator()(long&& x, const Emit& emit)
+    {
+        if (x % 5 != 0)
+            emit(std::move(x));
+    }
+};
+
+// splits, into move-only-ish strings
+struct Spell
+{
+    typedef long Input;
+
+    template <typename Emit>
+    void operator()(long&& x, const Emit& emit)
+    {
+        emit(std::to_string(x));
+        if (x % 2 == 0)
+            emit(std::string("even"));
+    }
+};
+
+struct Throwing
+{
+    typedef int Input;
+
+    template <typename Emit>
+    void operator()(int&& x, const Emit& emit)
+    {
+        if (x == 500)
+            throw std::runtime_error("500");
+        emit(static_cast<long>(x));
+    }
+};
+
+struct Collect
+{
+    std::vector<std::string> out;
+    void operator()(std::string&& s) { out.push_back(std::move(s)); }
+    void operator()(long x) { out.push_back(std::to_string(x)); }
+};
+
+typedef dea::TL::MakeTypelist<Scale,DropFives,Spell>::Result Stages;
+// tiny queues and batches, stages sleep after two empty polls
+typedef dea::ThreadedPipeline<4,3,2> Small;
+
+std::vector<std::string> Inline(int n)
+{
+    dea::Pipeline<Stages,Collect> pipeline;
+    for (int i = 0; i < n; ++i)
+        pipeline.Push(i);
+    pipeline.Close();
+    return pipeline.sink().out;
+}
+
+template <typename Mode>
+void SameOutput(int n, bool pause)
+{
+    const std::vector<std::string> expected = Inline(n);
+
+    dea::Pipeline<Stages,Collect,Mode> pipeline;
+    for (int i = 0; i < n; ++i)
+    {
+        pipeline.Push(i);
+        // let the stages run dry and fall asleep
+        if (pause && i % 100 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    pipeline.Close();
+    DEA_CHECK(pipeline.sink().out == expected);
+    DEA_CHECK(pipeline.template Stage<0>().seen ==
+        static_cast<std::size_t>(n));
+}
+
+void Error()
+{
+    typedef dea::TL::MakeTypelist<Throwing,DropFives>::Result Failing;
+    dea::Pipeline<Failing,Collect,Small> pipeline;
+    for (int i = 0; i < 1000; ++i)
+        pipeline.Push(i);
+    bool thrown = false;
+    try
+    {
+        pipeline.Close();
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    DEA_CHECK(thrown);
+    // everything before the failing item went through
+    std::size_t below = 0;
+    for (int i = 0; i < 500; ++i)
+        below += i % 5 != 0;
+    DEA_CHECK(pipeline.sink().out.size() == below);
+}
+
+} // namespace
+
+int main()
+{
+    DEA_CHECK(Inline(10).size() == 12);
+    SameOutput<dea::ThreadedPipeline<>>(20000,false);
+    SameOutput<Small>(20000,false);
+    SameOutput<Small>(1000,true);
+    Error();
+    return DEA_CHECK_RESULT;
+}
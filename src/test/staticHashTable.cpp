@@ -0,0 +1,149 @@
+/* {{{ LICENSE
+ * staticHashTable.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::StaticHashTable finds every key it was built from, at compile
+ * time and at run time, and rejects every other key, including keys
+ * that land in an occupied slot and keys that land in an empty one.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "staticHashTable.h"
+#include "typelist.h"
+#include "typemap.h"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <type_traits>
+// }}} Includes
+
+namespace
+{
+
+// {{{ Tables
+typedef dea::StaticHashTable<dea::TL::MakeTypelist<
+    dea::StaticHashEntry<dea::Int2Type<-7>,dea::Int2Type<70>>,
+    dea::StaticHashEntry<dea::Int2Type<0>,dea::Int2Type<0>>,
+    dea::StaticHashEntry<dea::Int2Type<0x17>,dea::Int2Type<-1>>,
+    dea::StaticHashEntry<dea::Int2Type<0x80>,dea::Int2Type<128>>,
+    dea::StaticHashEntry<dea::Int2Type<1 << 30>,dea::Int2Type<30>>,
+    dea::StaticHashEntry<dea::Int2Type<-2147483647 - 1>,dea::Int2Type<31>>
+    >::Result,int> Small;
+
+static_assert(Small::Contains(0x80) && Small::Get(0x80,5) == 128,
+    "Get at compile time");
+static_assert(!Small::Contains(0x81) && Small::Get(0x81,5) == 5,
+    "missing keys at compile time");
+static_assert(Small::Get<-7>() == 70, "Get<key>");
+
+typedef dea::StaticHashTable<dea::TL::MakeTypelist<
+    dea::StaticHashEntry<dea::Int2Type<42>,dea::Int2Type<1>>>::Result,
+    long> Single;
+
+int Hello() { return 1; }
+int Data() { return 2; }
+typedef int (*Handler)();
+template <Handler h>
+using H = std::integral_constant<Handler,h>;
+typedef dea::StaticHashTable<dea::TL::MakeTypelist<
+    dea::StaticHashEntry<dea::Int2Type<0x01>,H<Hello>>,
+    dea::StaticHashEntry<dea::Int2Type<0x17>,H<Data>>>::Result,
+    Handler> Handlers;
+
+// 64 sparse keys, negative ones included, valued by their position
+constexpr int WideKey(int i)
+{ return (i - 32) * (i - 32) * (i - 32) * 97 + i; }
+template <unsigned int... i>
+dea::StaticHashTable<typename dea::TL::MakeTypelist<
+    dea::StaticHashEntry<dea::Int2Type<WideKey(i)>,dea::Int2Type<i>>...
+    >::Result,int> MakeWide(dea::IndexSequence<i...>);
+typedef decltype(MakeWide(
+    dea::MakeIndexSequence<64>::Result())) Wide;
+// }}} Tables
+
+// every key in `entries` is found with its value, and no other key in
+// [-range,range], at the extremes or in the same slot as a key is
+template <typename Table>
+void Check(const std::map<int,int>& entries, int range)
+{
+    std::set<std::uint32_t> used;
+    for (const auto& entry : entries)
+    {
+        const typename Table::ValueType* value = Table::Find(entry.first);
+        DEA_CHECK(value && *value == entry.second);
+        DEA_CHECK(Table::Contains(entry.first));
+        DEA_CHECK(Table::Get(entry.first,-12345) == entry.second);
+        used.insert(Table::Index(entry.first));
+    }
+    DEA_CHECK(used.size() == entries.size());
+
+    const int extremes[] = { -2147483647 - 1, -2147483647, -1, 0, 1,
+        2147483646, 2147483647 };
+    std::mt19937 random(3);
+    std::size_t collisions = 0;
+    std::size_t empty = 0;
+    for (int i = 0; i < 100000; ++i)
+    {
+        const int key = i < 7 ? extremes[i]
+            : static_cast<int>(random() % (2u * range + 1)) - range;
+        if (entries.count(key))
+            continue;
+        DEA_CHECK(!Table::Find(key));
+        DEA_CHECK(!Table::Contains(key));
+        DEA_CHECK(Table::Get(key,-12345) == -12345);
+        ++(used.count(Table::Index(key)) ? collisions : empty);
+    }
+    // both kinds of miss were tried
+    DEA_CHECK(collisions > 0);
+    DEA_CHECK(empty > 0 || used.size() == Table::slots);
+}
+
+void Tables()
+{
+    Check<Small>({{-7,70},{0,0},{0x17,-1},{0x80,128},{1 << 30,30},
+        {-2147483647 - 1,31}},1000);
+    Check<Single>({{42,1}},100);
+
+    std::map<int,int> wide;
+    for (int i = 0; i < 64; ++i)
+        wide[WideKey(i)] = i;
+    Check<Wide>(wide,4000000);
+    DEA_CHECK(Wide::size == 64);
+    DEA_CHECK(Wide::slots <= 64 * 64 / 2);
+}
+
+void Functions()
+{
+    DEA_CHECK((*Handlers::Find(0x01))() == 1);
+    DEA_CHECK(Handlers::Get(0x17,nullptr)() == 2);
+    DEA_CHECK(!Handlers::Find(0x02));
+}
+
+} // namespace
+
+int main()
+{
+    Tables();
+    Functions();
+    return DEA_CHECK_RESULT;
+}
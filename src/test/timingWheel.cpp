@@ -0,0 +1,203 @@
+/* {{{ LICENSE
+ * timingWheel.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::TimingWheel on simulated time against a sorted reference: a
+ * small wheel of three levels of four slots, so that timers cascade
+ * through every level and timers beyond its 64 ticks get parked.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "timingWheel.h"
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+// }}} Includes
+
+namespace
+{
+
+typedef dea::TimingWheel<std::function<void()>,2,3> Wheel;
+
+class Harness
+{
+    struct Pending
+    {
+        Wheel::Tick expiry;
+        dea::TimerId id;
+    };
+
+    Wheel wheel_;
+    std::mt19937 random_;
+    // the reference, timers by expiry
+    std::multimap<Wheel::Tick,int> byExpiry_;
+    std::map<int,Pending> pending_;
+    std::vector<dea::TimerId> done_;
+    int next_ = 0;
+
+    public:
+        std::size_t fired = 0;
+
+        explicit Harness(unsigned int seed) : random_{seed} {}
+
+        Wheel::Tick Now() const { return wheel_.Now(); }
+
+        // a timer that may schedule and cancel others when it fires
+        void Schedule(Wheel::Tick delay, bool chain)
+        {
+            const int serial = next_++;
+            const dea::TimerId id = wheel_.Schedule(delay,
+                [this,serial,chain]{ Fire(serial,chain); });
+            const Wheel::Tick expiry = wheel_.Now() + (delay ? delay : 1);
+            pending_[serial] = Pending{expiry,id};
+            byExpiry_.insert(std::make_pair(expiry,serial));
+        }
+
+        void Schedule()
+        { Schedule(RandomDelay(),random_() % 4 == 0); }
+
+        // cancels a random pending timer that is not due yet
+        void CancelOne()
+        {
+            auto first = byExpiry_.upper_bound(wheel_.Now());
+            const std::size_t n = std::distance(first,byExpiry_.end());
+            if (n == 0)
+                return;
+            std::advance(first,random_() % n);
+            const dea::TimerId id = pending_[first->second].id;
+            DEA_CHECK(wheel_.Cancel(id));
+            DEA_CHECK(!wheel_.Cancel(id));
+            done_.push_back(id);
+            pending_.erase(first->second);
+            byExpiry_.erase(first);
+        }
+
+        // the fake clock jumps to `to`, the wheel catches up
+        void AdvanceTo(Wheel::Tick to)
+        {
+            wheel_.Advance(to - wheel_.Now());
+            DEA_CHECK(wheel_.Now() == to);
+            DEA_CHECK(byExpiry_.empty() || byExpiry_.begin()->first > to);
+            DEA_CHECK(wheel_.Size() == pending_.size());
+            // stale handles stay harmless
+            for (const dea::TimerId& id : done_)
+                DEA_CHECK(!wheel_.Cancel(id));
+            done_.clear();
+        }
+
+    private:
+        Wheel::Tick RandomDelay()
+        {
+            switch (random_() % 3)
+            {
+                case 0: return random_() % 8;
+                case 1: return random_() % 64;
+                default: return random_() % 1000;
+            }
+        }
+
+        void Fire(int serial,bool chain)
+        {
+            ++fired;
+            auto found = pending_.find(serial);
+            DEA_CHECK(found != pending_.end());
+            if (found == pending_.end())
+                return;
+            // fires exactly at its expiry, and only once
+            DEA_CHECK(found->second.expiry == wheel_.Now());
+            auto range = byExpiry_.equal_range(found->second.expiry);
+            for (auto it = range.first; it != range.second; ++it)
+                if (it->second == serial)
+                {
+                    byExpiry_.erase(it);
+                    break;
+                }
+            done_.push_back(found->second.id);
+            pending_.erase(found);
+
+            if (chain)
+            {
+                Schedule();
+                CancelOne();
+            }
+        }
+};
+
+// one timer per boundary of every level, plus parked ones
+void Levels()
+{
+    Harness h(1);
+    for (Wheel::Tick delay : { 0u, 1u, 3u, 4u, 5u, 15u, 16u, 17u, 63u,
+            64u, 65u, 127u, 128u, 200u, 4095u })
+        h.Schedule(delay,false);
+    for (Wheel::Tick t = 1; t <= 5000; ++t)
+        h.AdvanceTo(t);
+    DEA_CHECK(h.fired == 15);
+}
+
+void Random()
+{
+    Harness h(42);
+    std::mt19937 clock(7);
+    for (int i = 0; i < 3000; ++i)
+    {
+        h.Schedule();
+        if (i % 5 == 0)
+            h.CancelOne();
+        if (i % 3 == 0)
+            h.AdvanceTo(h.Now() + clock() % 40);
+    }
+    h.AdvanceTo(h.Now() + 100000);
+    DEA_CHECK(h.fired > 1000);
+}
+
+// a callback rescheduling itself keeps a period
+void Periodic()
+{
+    Wheel wheel;
+    std::vector<Wheel::Tick> at;
+    std::function<void()> tick = [&]()
+    {
+        at.push_back(wheel.Now());
+        if (at.size() < 5)
+            wheel.Schedule(70,tick);
+    };
+    wheel.Schedule(70,tick);
+    wheel.Advance(1000);
+    DEA_CHECK(at.size() == 5 && at.front() == 70 && at.back() == 350);
+    DEA_CHECK(wheel.Size() == 0);
+}
+
+} // namespace
+
+int main()
+{
+    Levels();
+    Random();
+    Periodic();
+    return DEA_CHECK_RESULT;
+}
@@ -0,0 +1,159 @@
+/* {{{ LICENSE
+ * tupleFile.cpp
+ * This file is part of cDea
+ *
+ * Copyright (C) 2012-2013 - KiNaudiz
+ *
+ * cDea is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3.0 of the License, or (at your option) any later version.
+ *
+ * cDea is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with cDea. If not, see <http://www.gnu.org/licenses/>.
+ * }}} */
+
+/*
+ * dea::TupleFile: records written by the Writer come back unchanged
+ * through the mapped View, files of another schema are rejected.
+ */
+
+// {{{ Includes
+#include "check.h"
+#include "hierarchy.h"
+#include "tupleFile.h"
+#include "typelist.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+// }}} Includes
+
+namespace
+{
+
+typedef typename dea::TL::MakeTypelist<int,double,char>::Result Row;
+typedef dea::TupleFile<Row> File;
+
+// a fresh path in the temporary directory, removed on destruction
+class TempPath
+{
+    std::string path_;
+
+    public:
+        TempPath()
+        {
+            const char* dir = std::getenv("TMPDIR");
+            path_ = std::string(dir ? dir : "/tmp") + "/deaTupleXXXXXX";
+            const int fd = ::mkstemp(&path_[0]);
+            if (fd >= 0)
+                ::close(fd);
+        }
+        ~TempPath() { ::unlink(path_.c_str()); }
+
+        const char* c_str() const { return path_.c_str(); }
+};
+
+std::vector<File::Record> Rows(int n)
+{
+    std::vector<File::Record> rows(n);
+    for (int i = 0; i < n; ++i)
+    {
+        dea::Field<0>(rows[i]) = i * 3 - 7;
+        dea::Field<1>(rows[i]) = i * 0.25;
+        dea::Field<2>(rows[i]) = static_cast<char>('a' + i % 26);
+    }
+    return rows;
+}
+
+template <typename F>
+bool Rejected(const TempPath& path)
+{
+    try
+    {
+        typename F::View view(path.c_str());
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+void RoundTrip()
+{
+    TempPath path;
+    const std::vector<File::Record> rows = Rows(1000);
+    {
+        File::Writer writer(path.c_str());
+        writer.Write(rows.data(),600);
+        for (std::size_t i = 600; i < rows.size(); ++i)
+            writer.Write(rows[i]);
+    }
+
+    File::View view(path.c_str());
+    DEA_CHECK(view.Size() == rows.size());
+    DEA_CHECK(reinterpret_cast<std::uintptr_t>(view.Data()) %
+        alignof(File::Record) == 0);
+    std::size_t i = 0;
+    for (const File::Record& row : view)
+    {
+        DEA_CHECK(row == rows[i]);
+        ++i;
+    }
+    DEA_CHECK(i == rows.size());
+    DEA_CHECK(dea::Field<2>(view[27]) == 'b');
+
+    // an empty file is valid
+    TempPath empty;
+    File::Writer(empty.c_str()).Close();
+    DEA_CHECK(File::View(empty.c_str()).Size() == 0);
+}
+
+void SchemaMismatch()
+{
+    TempPath path;
+    {
+        File::Writer writer(path.c_str());
+        const std::vector<File::Record> rows = Rows(10);
+        writer.Write(rows.data(),rows.size());
+    }
+    DEA_CHECK(!Rejected<File>(path));
+
+    // same fields in another order
+    typedef dea::TL::MakeTypelist<double,int,char>::Result Swapped;
+    DEA_CHECK(Rejected<dea::TupleFile<Swapped>>(path));
+    // same size and alignment, float instead of int
+    typedef dea::TL::MakeTypelist<float,double,char>::Result Floating;
+    DEA_CHECK(Rejected<dea::TupleFile<Floating>>(path));
+    // unsigned instead of signed
+    typedef dea::TL::MakeTypelist<unsigned int,double,char>::Result
+        Unsigned;
+    DEA_CHECK(Rejected<dea::TupleFile<Unsigned>>(path));
+
+    // fewer records on disk than the header claims
+    DEA_CHECK(::truncate(path.c_str(),
+        sizeof(dea::TupleFileHeader) + 9 * sizeof(File::Record)) == 0);
+    DEA_CHECK(Rejected<File>(path));
+    // not even a header
+    DEA_CHECK(::truncate(path.c_str(),10) == 0);
+    DEA_CHECK(Rejected<File>(path));
+}
+
+} // namespace
+
+int main()
+{
+    RoundTrip();
+    SchemaMismatch();
+    return DEA_CHECK_RESULT;
+}